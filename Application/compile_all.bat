@@ -25,7 +25,7 @@ echo.
 
 :: Compile Tree Structures
 echo [1/3] Compiling Tree Structures (BST File System)...
-gcc %FLAGS% -o bin\tree_structures.exe tree_structures.cpp
+gcc %FLAGS% -pthread -o bin\tree_structures.exe tree_structures.cpp
 if %errorlevel% neq 0 (
     echo ERROR: Failed to compile tree_structures.cpp
     pause
@@ -24,7 +24,7 @@ echo
 
 # Compile Tree Structures
 echo "[1/3] Compiling Tree Structures (BST File System)..."
-if g++ $FLAGS -o bin/tree_structures tree_structures.cpp; then
+if g++ $FLAGS -pthread -o bin/tree_structures tree_structures.cpp; then
     echo "     ✓ tree_structures created successfully"
 else
     echo "ERROR: Failed to compile tree_structures.cpp"
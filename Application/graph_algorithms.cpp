@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
+#include <random>
 using namespace std;
 using namespace std::chrono;
 
@@ -34,18 +35,208 @@ struct User {
         : name(n), profession(p), age(a), interests(i) {}
 };
 
+// Compact integer view of a graph: neighbours of u are adj[offsets[u] .. offsets[u+1]),
+// sorted ascending so traversals are deterministic without sorting at visit time.
+struct AdjacencyIndex {
+    vector<int> offsets{0};
+    vector<int> adj;
+    
+    int size() const { return (int)offsets.size() - 1; }
+};
+
+// Default no-op callbacks; visitors override only the hooks they need.
+struct DFSVisitor {
+    void preorder(int /*u*/) {}
+    void treeEdge(int /*u*/, int /*v*/) {}
+    void nonTreeEdge(int /*u*/, int /*v*/) {}
+    void postorder(int /*u*/, int /*parent*/) {}
+};
+
+// Iterative DFS over an AdjacencyIndex using an explicit stack of (node, next-edge) frames.
+// Each node is expanded once and each edge scanned once: O(V + E), no recursion, and no
+// allocation after the first run because the stack and visited marks are reused (also
+// across reset(g) calls, as long as the graph does not grow).
+class IterativeDFS {
+private:
+    struct Frame { int node; int nextEdge; };
+    
+    const AdjacencyIndex* graph;
+    vector<Frame> frames;
+    vector<char> visited;
+    
+public:
+    explicit IterativeDFS(const AdjacencyIndex& g) { reset(g); }
+    
+    void reset() { fill(visited.begin(), visited.end(), 0); }
+    
+    // Rebinds to g (which may have been rebuilt) and clears the visited marks
+    void reset(const AdjacencyIndex& g) {
+        graph = &g;
+        visited.assign(g.size(), 0);
+        frames.reserve(g.size());
+    }
+    bool isVisited(int u) const { return visited[u] != 0; }
+    
+    // Explores everything reachable from start that is not yet visited
+    template <typename Visitor>
+    void run(int start, Visitor& visitor) {
+        if (visited[start]) return;
+        visited[start] = 1;
+        visitor.preorder(start);
+        frames.push_back({start, graph->offsets[start]});
+        
+        while (!frames.empty()) {
+            Frame& top = frames.back();
+            if (top.nextEdge == graph->offsets[top.node + 1]) {
+                int done = top.node;
+                frames.pop_back();
+                visitor.postorder(done, frames.empty() ? -1 : frames.back().node);
+                continue;
+            }
+            int u = top.node;
+            int v = graph->adj[top.nextEdge++];
+            if (visited[v]) {
+                visitor.nonTreeEdge(u, v);
+            } else {
+                visited[v] = 1;
+                visitor.treeEdge(u, v);
+                visitor.preorder(v);
+                frames.push_back({v, graph->offsets[v]}); // may reallocate: `top` is not used after this
+            }
+        }
+    }
+};
+
+// Topological order of a directed graph (reverse postorder). Returns empty if there is a cycle.
+vector<int> topologicalOrder(const AdjacencyIndex& g) {
+    struct Topo : DFSVisitor {
+        vector<char> onPath;
+        vector<int> order;
+        bool cyclic = false;
+        void preorder(int u) { onPath[u] = 1; }
+        void nonTreeEdge(int, int v) { if (onPath[v]) cyclic = true; }
+        void postorder(int u, int) { onPath[u] = 0; order.push_back(u); }
+    } topo;
+    topo.onPath.assign(g.size(), 0);
+    
+    IterativeDFS dfs(g);
+    for (int u = 0; u < g.size(); u++) dfs.run(u, topo);
+    if (topo.cyclic) return {};
+    reverse(topo.order.begin(), topo.order.end());
+    return topo.order;
+}
+
+// Tarjan's strongly connected components; component[u] = id. On an undirected
+// (symmetric) graph these are the connected components.
+vector<int> stronglyConnectedComponents(const AdjacencyIndex& g, int& componentCount) {
+    struct Tarjan : DFSVisitor {
+        vector<int> index, low, component, pending;
+        vector<char> onStack;
+        int counter = 0, components = 0;
+        void preorder(int u) {
+            index[u] = low[u] = counter++;
+            pending.push_back(u);
+            onStack[u] = 1;
+        }
+        void nonTreeEdge(int u, int v) { if (onStack[v]) low[u] = min(low[u], index[v]); }
+        void postorder(int u, int parent) {
+            if (low[u] == index[u]) {
+                int w;
+                do {
+                    w = pending.back(); pending.pop_back();
+                    onStack[w] = 0;
+                    component[w] = components;
+                } while (w != u);
+                components++;
+            }
+            if (parent >= 0) low[parent] = min(low[parent], low[u]);
+        }
+    } tarjan;
+    int n = g.size();
+    tarjan.index.assign(n, -1); tarjan.low.assign(n, 0);
+    tarjan.component.assign(n, -1); tarjan.onStack.assign(n, 0);
+    
+    IterativeDFS dfs(g);
+    for (int u = 0; u < n; u++) dfs.run(u, tarjan);
+    componentCount = tarjan.components;
+    return tarjan.component;
+}
+
+// Articulation points of an undirected graph: vertices whose removal disconnects it.
+vector<int> articulationPoints(const AdjacencyIndex& g) {
+    struct Cut : DFSVisitor {
+        vector<int> disc, low, parent, children;
+        vector<char> isCut;
+        int counter = 0;
+        void preorder(int u) { disc[u] = low[u] = counter++; }
+        void treeEdge(int u, int v) { parent[v] = u; children[u]++; }
+        void nonTreeEdge(int u, int v) { if (v != parent[u]) low[u] = min(low[u], disc[v]); }
+        void postorder(int u, int p) {
+            if (p < 0) {
+                if (children[u] > 1) isCut[u] = 1; // root: cut vertex iff it has 2+ DFS children
+                return;
+            }
+            low[p] = min(low[p], low[u]);
+            if (parent[p] >= 0 && low[u] >= disc[p]) isCut[p] = 1;
+        }
+    } cut;
+    int n = g.size();
+    cut.disc.assign(n, -1); cut.low.assign(n, 0); cut.parent.assign(n, -1);
+    cut.children.assign(n, 0); cut.isCut.assign(n, 0);
+    
+    IterativeDFS dfs(g);
+    for (int u = 0; u < n; u++) dfs.run(u, cut);
+    
+    vector<int> result;
+    for (int u = 0; u < n; u++) if (cut.isCut[u]) result.push_back(u);
+    return result;
+}
+
 class SocialNetwork {
 private:
     unordered_map<string, vector<string>> adjacencyList;
     unordered_map<string, User> userProfiles;
     int totalEdges;
     
+    // Integer index rebuilt lazily after the network changes. Ids follow name order,
+    // so ascending-id neighbour lists visit friends alphabetically.
+    vector<string> idToName;
+    unordered_map<string, int> nameToId;
+    AdjacencyIndex index;
+    bool indexDirty = true;
+    
+    // DFS state kept next to the index and rebound to it on every dfsOrder call,
+    // so repeated traversals reuse the frame stack, visited marks and order buffer
+    IterativeDFS traversal{index};
+    vector<int> traversalOrder;
+    
+    const AdjacencyIndex& adjacencyIndex() {
+        if (!indexDirty) return index;
+        idToName.clear();
+        for (const auto& pair : adjacencyList) idToName.push_back(pair.first);
+        sort(idToName.begin(), idToName.end());
+        nameToId.clear();
+        for (size_t i = 0; i < idToName.size(); i++) nameToId[idToName[i]] = (int)i;
+        
+        index.offsets.assign(1, 0);
+        index.adj.clear();
+        for (const string& name : idToName) {
+            size_t rowStart = index.adj.size();
+            for (const string& friendName : adjacencyList[name]) index.adj.push_back(nameToId[friendName]);
+            sort(index.adj.begin() + rowStart, index.adj.end());
+            index.offsets.push_back((int)index.adj.size());
+        }
+        indexDirty = false;
+        return index;
+    }
+    
 public:
     SocialNetwork() : totalEdges(0) {}
     
     // Add a new user to the network
     void addUser(string name, string profession = "", int age = 0, vector<string> interests = {}) {
         userProfiles[name] = User(name, profession, age, interests);
+        indexDirty = true;
         // Initialize adjacency list if not exists
         if (adjacencyList.find(name) == adjacencyList.end()) {
             adjacencyList[name] = vector<string>();
@@ -62,10 +253,40 @@ public:
             addUser(user2);
         }
         
+        // Ignore self-friendship and repeats so degrees and edge counts stay honest
+        if (user1 == user2 || areFriends(user1, user2)) {
+            return;
+        }
+        
         // Add bidirectional connection
         adjacencyList[user1].push_back(user2);
         adjacencyList[user2].push_back(user1);
         totalEdges++;
+        indexDirty = true;
+    }
+    
+    bool areFriends(const string& user1, const string& user2) const {
+        auto it = adjacencyList.find(user1);
+        if (it == adjacencyList.end()) return false;
+        return find(it->second.begin(), it->second.end(), user2) != it->second.end();
+    }
+    
+    // Remove friendship (undirected) - O(degree) per endpoint
+    bool removeFriendship(const string& user1, const string& user2) {
+        if (!areFriends(user1, user2)) {
+            return false;
+        }
+        
+        auto dropFrom = [](vector<string>& friends, const string& name) {
+            auto pos = find(friends.begin(), friends.end(), name);
+            *pos = friends.back(); // order of friends is not significant
+            friends.pop_back();
+        };
+        dropFrom(adjacencyList[user1], user2);
+        dropFrom(adjacencyList[user2], user1);
+        totalEdges--;
+        indexDirty = true;
+        return true;
     }
     
     // Display the complete social network
@@ -167,12 +388,47 @@ public:
         cout << "\n🕳️ DFS Network Analysis from '" << startUser << "':\n";
         cout << "(Simulating deep connection analysis)\n\n";
         
+        auto start = high_resolution_clock::now();
+        vector<string> traversalPath = dfsOrder(startUser);
+        auto end = high_resolution_clock::now();
+        auto duration = duration_cast<microseconds>(end - start);
+        
+        cout << "DFS Path: ";
+        for (size_t i = 0; i < traversalPath.size(); i++) {
+            cout << traversalPath[i];
+            if (i < traversalPath.size() - 1) cout << " → ";
+        }
+        cout << endl;
+        
+        cout << "⏱️ DFS completed in " << duration.count() << " microseconds\n";
+        cout << "👥 Total users reached: " << traversalPath.size() << endl;
+    }
+    
+    // Preorder DFS (friends visited alphabetically) over the cached integer index
+    vector<string> dfsOrder(const string& startUser) {
+        const AdjacencyIndex& g = adjacencyIndex();
+        struct Collect : DFSVisitor {
+            vector<int>& order;
+            explicit Collect(vector<int>& out) : order(out) {}
+            void preorder(int u) { order.push_back(u); }
+        } collect(traversalOrder);
+        traversalOrder.clear();
+        traversal.reset(g);
+        traversal.run(nameToId.at(startUser), collect);
+        
+        vector<string> names;
+        names.reserve(traversalOrder.size());
+        for (int id : traversalOrder) names.push_back(idToName[id]);
+        return names;
+    }
+    
+    // Original string-based DFS, kept as the reference for benchmarks: copies and
+    // reverse-sorts every neighbour list on each pop, O(E log d) plus allocations.
+    vector<string> dfsOrderReference(const string& startUser) {
         unordered_set<string> visited;
         stack<string> dfsStack;
         vector<string> traversalPath;
         
-        auto start = high_resolution_clock::now();
-        
         dfsStack.push(startUser);
         
         while (!dfsStack.empty()) {
@@ -183,7 +439,6 @@ public:
                 visited.insert(currentUser);
                 traversalPath.push_back(currentUser);
                 
-                // Add neighbors to stack (in reverse order for consistent traversal)
                 vector<string> neighbors = adjacencyList[currentUser];
                 sort(neighbors.rbegin(), neighbors.rend());
                 
@@ -194,19 +449,22 @@ public:
                 }
             }
         }
-        
-        auto end = high_resolution_clock::now();
-        auto duration = duration_cast<microseconds>(end - start);
-        
-        cout << "DFS Path: ";
-        for (size_t i = 0; i < traversalPath.size(); i++) {
-            cout << traversalPath[i];
-            if (i < traversalPath.size() - 1) cout << " → ";
-        }
-        cout << endl;
-        
-        cout << "⏱️ DFS completed in " << duration.count() << " microseconds\n";
-        cout << "👥 Total users reached: " << visited.size() << endl;
+        return traversalPath;
+    }
+    
+    // Users whose removal would split the network (articulation points)
+    vector<string> findKeyConnectors() {
+        const AdjacencyIndex& g = adjacencyIndex();
+        vector<string> names;
+        for (int id : articulationPoints(g)) names.push_back(idToName[id]);
+        return names;
+    }
+    
+    // Number of separate friend circles (connected components)
+    int countFriendCircles() {
+        int circles = 0;
+        stronglyConnectedComponents(adjacencyIndex(), circles);
+        return circles;
     }
     
     // Find mutual friends between two users
@@ -329,6 +587,67 @@ public:
     }
 };
 
+// Topological order on a small directed graph of onboarding steps (an edge
+// means "comes before"), then again with one edge reversed to form a cycle
+void demoTopologicalOrder() {
+    const vector<string> steps = {"Sign up", "Verify email", "Add photo", "Import contacts",
+                                  "Follow suggestions", "First post"};
+    vector<pair<int, int>> edges = {{0, 1}, {1, 2}, {1, 3}, {3, 4}, {2, 5}, {4, 5}};
+    auto build = [&](const vector<pair<int, int>>& directed) {
+        vector<vector<int>> out(steps.size());
+        for (auto [u, v] : directed) out[u].push_back(v);
+        AdjacencyIndex g;
+        for (auto& neighbours : out) {
+            sort(neighbours.begin(), neighbours.end());
+            g.adj.insert(g.adj.end(), neighbours.begin(), neighbours.end());
+            g.offsets.push_back((int)g.adj.size());
+        }
+        return g;
+    };
+    
+    cout << "\n📋 Topological Order (onboarding steps):\n";
+    vector<int> order = topologicalOrder(build(edges));
+    vector<int> position(steps.size());
+    for (size_t i = 0; i < order.size(); i++) position[order[i]] = (int)i;
+    bool valid = order.size() == steps.size();
+    for (auto [u, v] : edges) valid = valid && position[u] < position[v];
+    for (size_t i = 0; i < order.size(); i++) cout << (i ? " → " : "") << steps[order[i]];
+    cout << "\n" << (valid ? "✅" : "❌") << " every step comes after its prerequisites\n";
+    
+    edges.push_back({5, 1}); // "First post" before "Verify email" closes a cycle
+    bool rejected = topologicalOrder(build(edges)).empty();
+    cout << (rejected ? "✅" : "❌") << " with First post → Verify email added, the cycle is detected (no order)\n";
+}
+
+// Compares the reference string DFS against the iterative index DFS on a synthetic network
+void benchmarkDFS(int users, int friendsPerUser) {
+    SocialNetwork network;
+    mt19937 rng(42);
+    auto name = [](int i) { return "user" + to_string(i); };
+    for (int i = 0; i < users; i++) network.addUser(name(i));
+    for (int i = 0; i < users; i++) {
+        for (int k = 0; k < friendsPerUser / 2; k++) {
+            network.addFriendship(name(i), name(rng() % users));
+        }
+    }
+    
+    auto timeIt = [](auto fn) {
+        auto start = high_resolution_clock::now();
+        fn();
+        return duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+    };
+    vector<string> reference, firstRun, cachedRun;
+    long long referenceTime = timeIt([&] { reference = network.dfsOrderReference(name(0)); });
+    long long firstTime = timeIt([&] { firstRun = network.dfsOrder(name(0)); });
+    long long cachedTime = timeIt([&] { cachedRun = network.dfsOrder(name(0)); });
+    
+    cout << "\n⚡ DFS Benchmark (" << users << " users, ~" << friendsPerUser << " friends each):\n";
+    cout << "├── Reference (copy + sort per pop): " << referenceTime << " μs\n";
+    cout << "├── Iterative frames, incl. index build: " << firstTime << " μs\n";
+    cout << "├── Iterative frames, cached index and DFS state: " << cachedTime << " μs\n";
+    cout << "└── Same visiting order: " << (reference == firstRun && firstRun == cachedRun ? "✅ yes" : "❌ no") << endl;
+}
+
 int main() {
     cout << "=== 🌐 Social Network Analysis (Graph Algorithms) ===\n\n";
     
@@ -376,6 +695,20 @@ int main() {
     // Demonstrate DFS (Deep Network Analysis)
     network.dfsTraversal("Alice");
     
+    // DFS-based structure analysis
+    cout << "\n🔗 Friend circles (connected components): " << network.countFriendCircles() << endl;
+    vector<string> connectors = network.findKeyConnectors();
+    cout << "🌉 Key connectors (removal splits the network): ";
+    if (connectors.empty()) {
+        cout << "None - every user has an alternative route\n";
+    } else {
+        for (size_t i = 0; i < connectors.size(); i++) {
+            cout << connectors[i];
+            if (i < connectors.size() - 1) cout << ", ";
+        }
+        cout << endl;
+    }
+    
     // Show friend suggestions
     network.suggestFriends("Alice");
     network.suggestFriends("Henry");
@@ -394,14 +727,29 @@ int main() {
         cout << endl;
     }
     
+    // Friendships change over time: duplicates are ignored, removals are supported
+    cout << "\n🔄 Dynamic Updates:\n";
+    network.addFriendship("Alice", "Bob"); // already friends - ignored
+    cout << "Re-adding Alice-Bob is ignored (connection count unchanged):";
+    network.analyzeNetwork();
+    if (network.removeFriendship("Grace", "Henry")) {
+        cout << "Removed Grace-Henry; suggestions for Henry now:";
+        network.suggestFriends("Henry");
+        network.addFriendship("Grace", "Henry"); // restore for the rest of the demo
+    }
+    
     // Show detailed user profiles
     network.showUserProfile("Alice");
     network.showUserProfile("Bob");
     
+    demoTopologicalOrder();
+    benchmarkDFS(20000, 10);
+    
     cout << "\n🧩 Graph Concepts Demonstrated:\n";
     cout << "• 🌐 Adjacency list representation for efficient storage\n";
     cout << "• 🔍 BFS for shortest path and level-wise exploration\n";
     cout << "• 🕳️ DFS for deep traversal and connectivity analysis\n";
+    cout << "• 🧭 Iterative DFS frames with callbacks: components, cut vertices, topological order\n";
     cout << "• 🤝 Practical applications: friend suggestions, mutual connections\n";
     cout << "• 📊 Network analysis: density, centrality, clustering\n\n";
     
@@ -6,10 +6,22 @@
  * Modern file systems and databases use B-Trees and other tree variants for
  * efficient storage and retrieval operations.
  * 
+ * The BST is self-balancing (AVL): directory listings arrive already sorted,
+ * which would degrade a plain BST into a linked list.
+ * 
  * Time Complexity:
- * - Insert: O(log n) average, O(n) worst case (unbalanced)
- * - Search: O(log n) average, O(n) worst case (unbalanced) 
+ * - Insert: O(log n) guaranteed (AVL rotations keep height <= 1.44 log2 n)
+ * - Search: O(log n) guaranteed
  * - Traversal: O(n)
+ * 
+ * Traversals are iterative (explicit stacks / const_iterator), so output and
+ * statistics never depend on call stack depth.
+ * 
+ * Run with --bench [n] to time sorted vs random insertion of n files, or with
+ * --scan <path> [threads] to load the tree from a real directory.
+ * --concurrent [n] [readers] measures read latency of ConcurrentFileIndex
+ * (lock-free readers, batched path-copying writer) under heavy updates.
+ * --snapshots [n] compares PersistentFileTree's O(1) snapshots with deep copies.
  */
 
 #include <iostream>
@@ -17,147 +29,918 @@
 #include <vector>
 #include <chrono>
 #include <iomanip>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <filesystem>
+#include <system_error>
+#include <stdexcept>
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 using namespace std;
 using namespace std::chrono;
 
+// 🧱 NodePool<T>: typed slab allocator for tree and list nodes
+//
+// Nodes are carved from SlabBytes-sized, SlabBytes-aligned slabs, so nodes
+// allocated together sit next to each other and one slab serves hundreds of
+// allocations. Freed nodes go on an intrusive LIFO free list and are reused
+// before the pool grows. Each slab keeps a live bitmap so clear() (and the
+// destructor) can run the destructors of the remaining nodes and return
+// whole slabs at once, without the owner walking its structure.
+// A pool is not thread-safe. Opting into threadLocal() gives each thread its
+// own pool, and since a slab is first touched by the thread that carves it,
+// first-touch placement keeps that thread's nodes on its own NUMA node.
+template <typename T, size_t SlabBytes = 64 * 1024>
+class NodePool {
+    static_assert((SlabBytes & (SlabBytes - 1)) == 0, "slab size must be a power of two");
+    
+    union Slot {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    
+    static constexpr size_t MAX_SLOTS = SlabBytes / sizeof(Slot);
+    static constexpr size_t BITMAP_WORDS = (MAX_SLOTS + 63) / 64;
+    
+    struct SlabHeader {
+        size_t liveCount;
+        uint64_t live[BITMAP_WORDS];
+    };
+    
+    static constexpr size_t HEADER_BYTES = (sizeof(SlabHeader) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    
+public:
+    static constexpr size_t SLOTS_PER_SLAB = (SlabBytes - HEADER_BYTES) / sizeof(Slot);
+    static_assert(SLOTS_PER_SLAB >= 8, "slab too small for this node type");
+    
+private:
+    vector<SlabHeader*> slabs;
+    Slot* freeList;
+    size_t bumpIndex; // next never-used slot in the newest slab
+    size_t liveNodes;
+    
+    static Slot* slotsOf(SlabHeader* slab) {
+        return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(slab) + HEADER_BYTES);
+    }
+    
+    static SlabHeader* slabOf(const void* p) {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(SlabBytes - 1));
+    }
+    
+    static size_t indexOf(SlabHeader* slab, const void* p) {
+        return static_cast<const Slot*>(p) - slotsOf(slab);
+    }
+    
+    Slot* takeSlot() {
+        if (freeList) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+        if (slabs.empty() || bumpIndex == SLOTS_PER_SLAB) {
+            void* memory = ::operator new(SlabBytes, align_val_t(SlabBytes));
+            SlabHeader* slab = new (memory) SlabHeader();
+            slabs.push_back(slab);
+            bumpIndex = 0;
+        }
+        return slotsOf(slabs.back()) + bumpIndex++;
+    }
+    
+public:
+    NodePool() : freeList(nullptr), bumpIndex(0), liveNodes(0) {}
+    ~NodePool() { clear(); }
+    
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = takeSlot();
+        T* node = new (slot->storage) T(std::forward<Args>(args)...);
+        SlabHeader* slab = slabOf(slot);
+        size_t i = indexOf(slab, slot);
+        slab->live[i / 64] |= uint64_t(1) << (i % 64);
+        slab->liveCount++;
+        liveNodes++;
+        return node;
+    }
+    
+    void destroy(T* node) {
+        if (!node) return;
+        node->~T();
+        SlabHeader* slab = slabOf(node);
+        size_t i = indexOf(slab, node);
+        slab->live[i / 64] &= ~(uint64_t(1) << (i % 64));
+        slab->liveCount--;
+        liveNodes--;
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+    
+    // Destroys every live node and returns all slabs in one pass
+    void clear() {
+        for (SlabHeader* slab : slabs) {
+            if (!is_trivially_destructible<T>::value && slab->liveCount > 0) {
+                Slot* slots = slotsOf(slab);
+                for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                    for (uint64_t bits = slab->live[w]; bits; bits &= bits - 1) {
+                        reinterpret_cast<T*>(slots[w * 64 + __builtin_ctzll(bits)].storage)->~T();
+                    }
+                }
+            }
+            slab->~SlabHeader();
+            ::operator delete(slab, align_val_t(SlabBytes));
+        }
+        slabs.clear();
+        freeList = nullptr;
+        bumpIndex = 0;
+        liveNodes = 0;
+    }
+    
+    // Per-thread pool; nodes must be destroyed on the thread that created them,
+    // and any still live are freed when the thread exits
+    static NodePool& threadLocal() {
+        thread_local NodePool pool;
+        return pool;
+    }
+    
+    size_t size() const { return liveNodes; }
+    size_t capacity() const { return slabs.size() * SLOTS_PER_SLAB; }
+    size_t slabCount() const { return slabs.size(); }
+    size_t reservedBytes() const { return slabs.size() * SlabBytes; }
+    // Fraction of carved-out slots holding live nodes (1.0 = no holes)
+    double utilization() const {
+        size_t carved = slabs.empty() ? 0 : (slabs.size() - 1) * SLOTS_PER_SLAB + bumpIndex;
+        return carved ? (double)liveNodes / carved : 1.0;
+    }
+};
+
+// File types tracked per subtree; anything else only counts towards the totals
+const string FILE_TYPES[] = {"folder", "document", "image", "video", "audio", "file"};
+const int FILE_TYPE_COUNT = 6;
+
+int fileTypeIndex(const string& type) {
+    for (int i = 0; i < FILE_TYPE_COUNT; i++) {
+        if (FILE_TYPES[i] == type) return i;
+    }
+    return -1;
+}
+
 // Enhanced Node structure for Binary Search Tree
+// Subtree aggregates are maintained on every insert, delete and rotation.
 struct FileNode {
     string fileName;
     string fileType;
     int fileSize; // in KB
+    int typeId;   // index into FILE_TYPES, -1 for other types
+    int height;   // height of the subtree rooted here (leaf = 1)
+    int subtreeCount;
+    long long subtreeSize; // KB in this subtree
+    int typeCounts[FILE_TYPE_COUNT];
     FileNode* left;
     FileNode* right;
     
     FileNode(string name, string type = "file", int size = 0) 
-        : fileName(name), fileType(type), fileSize(size), left(nullptr), right(nullptr) {}
+        : fileName(name), fileType(type), fileSize(size), typeId(fileTypeIndex(type)), height(1),
+          subtreeCount(1), subtreeSize(size), typeCounts{}, left(nullptr), right(nullptr) {
+        if (typeId >= 0) typeCounts[typeId] = 1;
+    }
 };
 
+// 🗄️ Cache-conscious B+-tree index over file names (FileMetadataIndex)
+//
+// Each node is CacheLines * 64 bytes, aligned to a cache line, so a lookup
+// costs roughly one node fetch per level instead of one FileNode (plus its
+// two heap strings) per level. Keys are stored inline as 8-byte abbreviated
+// keys (big-endian, so integer order == string order) plus an offset into a
+// shared name arena; the arena is only touched when two abbreviations tie.
+// With prefix compression each node keeps the prefix shared by all its keys
+// (up to PREFIX_BYTES) in its header and abbreviates the bytes after it, so
+// names like "file000123.dat" still differ inside the inline 8 bytes.
+// Leaves are linked left-to-right for sorted and range scans.
+template <int CacheLines = 8>
+class FileMetadataIndex {
+public:
+    static constexpr int CACHE_LINE = 64;
+    static constexpr int NODE_BYTES = CacheLines * CACHE_LINE;
+    static_assert(CacheLines >= 4 && CacheLines <= 16, "node size should span 4-16 cache lines");
+
+private:
+    static constexpr int PREFIX_BYTES = 12;
+
+    struct NameRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct KeySlot {
+        uint64_t abbrev; // 8 bytes following the node prefix, zero padded
+        NameRef name;
+    };
+
+    struct FileRecord {
+        uint16_t typeId;
+        int size;
+    };
+
+    struct NodeHeader {
+        uint16_t count;
+        uint8_t prefixLength;
+        bool isLeaf;
+        char prefix[PREFIX_BYTES];
+    };
+
+    static constexpr int HEADER_BYTES = sizeof(NodeHeader);
+    static constexpr int LEAF_SLOTS =
+        (NODE_BYTES - HEADER_BYTES - (int)sizeof(void*)) / (int)(sizeof(KeySlot) + sizeof(uint32_t));
+    static constexpr int INNER_SLOTS =
+        (NODE_BYTES - HEADER_BYTES - (int)sizeof(void*)) / (int)(sizeof(KeySlot) + sizeof(void*));
+
+    struct alignas(CACHE_LINE) LeafNode : NodeHeader {
+        KeySlot keys[LEAF_SLOTS];
+        uint32_t records[LEAF_SLOTS]; // index into FileMetadataIndex::records
+        LeafNode* next;
+    };
+
+    struct alignas(CACHE_LINE) InnerNode : NodeHeader {
+        KeySlot keys[INNER_SLOTS];
+        NodeHeader* children[INNER_SLOTS + 1];
+    };
+
+    static_assert(sizeof(LeafNode) == NODE_BYTES, "leaf must fill its cache lines exactly");
+    static_assert(sizeof(InnerNode) == NODE_BYTES, "inner node must fill its cache lines exactly");
+
+    struct Split {
+        NameRef separator;
+        NodeHeader* right; // nullptr when the child did not split
+    };
+
+    NodeHeader* root;
+    LeafNode* firstLeaf;
+    vector<char> nameArena;
+    vector<FileRecord> records;
+    vector<string> typeNames;
+    bool prefixCompression;
+    int treeHeight;
+    size_t nodeCount;
+    size_t liveCount;
+
+    string_view nameOf(NameRef ref) const {
+        return string_view(nameArena.data() + ref.offset, ref.length);
+    }
+
+    static KeySlot* keysOf(NodeHeader* node) {
+        return node->isLeaf ? static_cast<LeafNode*>(node)->keys : static_cast<InnerNode*>(node)->keys;
+    }
+
+    static uint64_t abbreviate(string_view name, size_t from) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; i++) {
+            value <<= 8;
+            if (from + i < name.size()) value |= (unsigned char)name[from + i];
+        }
+        return value;
+    }
+
+    // Number of keys in the node that are < name (or <= name when inclusive).
+    int findSlot(const NodeHeader* node, const KeySlot* keys, string_view name, bool inclusive) const {
+        int count = node->count;
+        size_t p = node->prefixLength;
+        if (p > 0) {
+            int c = name.substr(0, p).compare(string_view(node->prefix, p));
+            if (c < 0) return 0;
+            if (c > 0) return count;
+        }
+        uint64_t probe = abbreviate(name, p);
+        int lo = 0, hi = count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            const KeySlot& key = keys[mid];
+            bool goRight;
+            if (key.abbrev != probe) {
+                goRight = key.abbrev < probe;
+            } else {
+                int c = nameOf(key.name).compare(name);
+                goRight = inclusive ? c <= 0 : c < 0;
+            }
+            if (goRight) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // Rewrites a node's key slots from name references, recomputing its prefix.
+    void setKeys(NodeHeader* node, const NameRef* refs, int count) {
+        KeySlot* keys = keysOf(node);
+        size_t p = 0;
+        if (prefixCompression && count > 0) {
+            string_view first = nameOf(refs[0]), last = nameOf(refs[count - 1]);
+            size_t limit = min({first.size(), last.size(), (size_t)PREFIX_BYTES});
+            while (p < limit && first[p] == last[p]) p++;
+            memcpy(node->prefix, first.data(), p);
+        }
+        node->prefixLength = (uint8_t)p;
+        node->count = (uint16_t)count;
+        for (int i = 0; i < count; i++) {
+            keys[i].name = refs[i];
+            keys[i].abbrev = abbreviate(nameOf(refs[i]), p);
+        }
+    }
+
+    // Opens slot pos for a new key; shrinks the node prefix first if the key does not share it.
+    void insertKey(NodeHeader* node, int pos, NameRef ref) {
+        KeySlot* keys = keysOf(node);
+        string_view name = nameOf(ref);
+        size_t p = node->prefixLength;
+        size_t common = 0;
+        while (common < p && common < name.size() && name[common] == node->prefix[common]) common++;
+        if (common < p) {
+            node->prefixLength = (uint8_t)common;
+            for (int i = 0; i < node->count; i++) keys[i].abbrev = abbreviate(nameOf(keys[i].name), common);
+        }
+        memmove(keys + pos + 1, keys + pos, (node->count - pos) * sizeof(KeySlot));
+        keys[pos].name = ref;
+        keys[pos].abbrev = abbreviate(name, node->prefixLength);
+        node->count++;
+    }
+
+    LeafNode* newLeaf() {
+        LeafNode* leaf = new LeafNode();
+        leaf->isLeaf = true;
+        nodeCount++;
+        return leaf;
+    }
+
+    InnerNode* newInner() {
+        InnerNode* inner = new InnerNode();
+        inner->isLeaf = false;
+        nodeCount++;
+        return inner;
+    }
+
+    Split insertInto(NodeHeader* node, NameRef ref, uint32_t record, bool& inserted) {
+        string_view name = nameOf(ref);
+
+        if (node->isLeaf) {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            int pos = findSlot(leaf, leaf->keys, name, false);
+            if (pos < leaf->count && nameOf(leaf->keys[pos].name) == name) {
+                inserted = false; // duplicate name: keep the existing entry
+                return {NameRef{0, 0}, nullptr};
+            }
+            inserted = true;
+
+            if (leaf->count < LEAF_SLOTS) {
+                insertKey(leaf, pos, ref);
+                memmove(leaf->records + pos + 1, leaf->records + pos, (leaf->count - 1 - pos) * sizeof(uint32_t));
+                leaf->records[pos] = record;
+                return {NameRef{0, 0}, nullptr};
+            }
+
+            // Full leaf: merge in the new key, then split the run in half.
+            NameRef refs[LEAF_SLOTS + 1];
+            uint32_t recs[LEAF_SLOTS + 1];
+            for (int i = 0, j = 0; i <= LEAF_SLOTS; i++) {
+                if (i == pos) { refs[i] = ref; recs[i] = record; }
+                else { refs[i] = leaf->keys[j].name; recs[i] = leaf->records[j]; j++; }
+            }
+            int half = (LEAF_SLOTS + 1) / 2;
+            LeafNode* right = newLeaf();
+            setKeys(leaf, refs, half);
+            setKeys(right, refs + half, LEAF_SLOTS + 1 - half);
+            memcpy(leaf->records, recs, half * sizeof(uint32_t));
+            memcpy(right->records, recs + half, (LEAF_SLOTS + 1 - half) * sizeof(uint32_t));
+            right->next = leaf->next;
+            leaf->next = right;
+            return {refs[half], right};
+        }
+
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        int child = findSlot(inner, inner->keys, name, true);
+        Split split = insertInto(inner->children[child], ref, record, inserted);
+        if (!split.right) return split;
+
+        if (inner->count < INNER_SLOTS) {
+            insertKey(inner, child, split.separator);
+            memmove(inner->children + child + 2, inner->children + child + 1,
+                    (inner->count - 1 - child) * sizeof(NodeHeader*));
+            inner->children[child + 1] = split.right;
+            return {NameRef{0, 0}, nullptr};
+        }
+
+        // Full inner node: merge, then push the middle separator up.
+        NameRef refs[INNER_SLOTS + 1];
+        NodeHeader* kids[INNER_SLOTS + 2];
+        for (int i = 0, j = 0; i <= INNER_SLOTS; i++) {
+            refs[i] = (i == child) ? split.separator : inner->keys[j++].name;
+        }
+        for (int i = 0, j = 0; i <= INNER_SLOTS + 1; i++) {
+            kids[i] = (i == child + 1) ? split.right : inner->children[j++];
+        }
+        int mid = (INNER_SLOTS + 1) / 2;
+        InnerNode* right = newInner();
+        setKeys(inner, refs, mid);
+        setKeys(right, refs + mid + 1, INNER_SLOTS - mid);
+        memcpy(inner->children, kids, (mid + 1) * sizeof(NodeHeader*));
+        memcpy(right->children, kids + mid + 1, (INNER_SLOTS + 1 - mid) * sizeof(NodeHeader*));
+        return {refs[mid], right};
+    }
+
+    const LeafNode* findLeaf(string_view name) const {
+        const NodeHeader* node = root;
+        while (!node->isLeaf) {
+            const InnerNode* inner = static_cast<const InnerNode*>(node);
+            node = inner->children[findSlot(inner, inner->keys, name, true)];
+        }
+        return static_cast<const LeafNode*>(node);
+    }
+
+    void destroy(NodeHeader* node) {
+        if (node->isLeaf) {
+            delete static_cast<LeafNode*>(node);
+            return;
+        }
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (int i = 0; i <= inner->count; i++) destroy(inner->children[i]);
+        delete inner;
+    }
+
+public:
+    explicit FileMetadataIndex(bool usePrefixCompression = true)
+        : root(nullptr), firstLeaf(nullptr), prefixCompression(usePrefixCompression),
+          treeHeight(1), nodeCount(0), liveCount(0) {
+        firstLeaf = newLeaf();
+        root = firstLeaf;
+    }
+
+    ~FileMetadataIndex() { destroy(root); }
+
+    FileMetadataIndex(const FileMetadataIndex&) = delete;
+    FileMetadataIndex& operator=(const FileMetadataIndex&) = delete;
+
+    // Returns false if a file with this name is already indexed.
+    bool insert(string_view fileName, const string& fileType = "file", int fileSize = 0) {
+        uint16_t typeId = 0;
+        while (typeId < typeNames.size() && typeNames[typeId] != fileType) typeId++;
+        if (typeId == typeNames.size()) typeNames.push_back(fileType);
+
+        NameRef ref{(uint32_t)nameArena.size(), (uint32_t)fileName.size()};
+        nameArena.insert(nameArena.end(), fileName.begin(), fileName.end());
+        records.push_back({typeId, fileSize});
+
+        bool inserted = false;
+        Split split = insertInto(root, ref, (uint32_t)(records.size() - 1), inserted);
+        if (!inserted) {
+            nameArena.resize(ref.offset);
+            records.pop_back();
+            return false;
+        }
+        if (split.right) {
+            InnerNode* newRoot = newInner();
+            setKeys(newRoot, &split.separator, 1);
+            newRoot->children[0] = root;
+            newRoot->children[1] = split.right;
+            root = newRoot;
+            treeHeight++;
+        }
+        liveCount++;
+        return true;
+    }
+    
+    // Removes a file from its leaf. Leaves are not merged on underflow, and the
+    // name stays in the arena (inner separators may still reference it).
+    bool remove(string_view fileName) {
+        LeafNode* leaf = const_cast<LeafNode*>(findLeaf(fileName));
+        int pos = findSlot(leaf, leaf->keys, fileName, false);
+        if (pos >= leaf->count || nameOf(leaf->keys[pos].name) != fileName) return false;
+        
+        int tail = leaf->count - 1 - pos;
+        memmove(leaf->keys + pos, leaf->keys + pos + 1, tail * sizeof(KeySlot));
+        memmove(leaf->records + pos, leaf->records + pos + 1, tail * sizeof(uint32_t));
+        leaf->count--;
+        liveCount--;
+        return true;
+    }
+
+    bool contains(string_view fileName) const {
+        const LeafNode* leaf = findLeaf(fileName);
+        int pos = findSlot(leaf, leaf->keys, fileName, false);
+        return pos < leaf->count && nameOf(leaf->keys[pos].name) == fileName;
+    }
+
+    // Visits files with from <= name <= to in sorted order by walking the leaf chain.
+    // fn(name, type, sizeKB) returns false to stop early.
+    template <typename Visitor>
+    void scanRange(string_view from, string_view to, Visitor fn) const {
+        const LeafNode* leaf = findLeaf(from);
+        int pos = findSlot(leaf, leaf->keys, from, false);
+        for (; leaf; leaf = leaf->next, pos = 0) {
+            for (; pos < leaf->count; pos++) {
+                string_view name = nameOf(leaf->keys[pos].name);
+                if (name > to) return;
+                const FileRecord& rec = records[leaf->records[pos]];
+                if (!fn(name, typeNames[rec.typeId], rec.size)) return;
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEachSorted(Visitor fn) const {
+        for (const LeafNode* leaf = firstLeaf; leaf; leaf = leaf->next) {
+            for (int pos = 0; pos < leaf->count; pos++) {
+                const FileRecord& rec = records[leaf->records[pos]];
+                fn(nameOf(leaf->keys[pos].name), typeNames[rec.typeId], rec.size);
+            }
+        }
+    }
+
+    size_t size() const { return liveCount; }
+    int height() const { return treeHeight; }
+    size_t memoryBytes() const { return nodeCount * NODE_BYTES + nameArena.size() + records.size() * sizeof(FileRecord); }
+    static int leafFanout() { return LEAF_SLOTS; }
+    static int innerFanout() { return INNER_SLOTS + 1; }
+};
+
+// One row of the sorted file table
+void printFileRow(string_view fileName, const string& fileType, int fileSize) {
+    string icon = "📄";
+    if (fileType == "folder") icon = "📁";
+    else if (fileType == "image") icon = "🖼️";
+    else if (fileType == "video") icon = "🎥";
+    else if (fileType == "audio") icon = "🎵";
+    else if (fileType == "document") icon = "📝";
+    
+    cout << icon << " " << left << setw(20) << string(fileName);
+    cout << " | " << left << setw(10) << fileType;
+    if (fileSize > 0) cout << " | " << right << setw(8) << fileSize << " KB";
+    cout << endl;
+}
+
 class FileSystemBST {
 private:
+    NodePool<FileNode> nodePool; // owns every FileNode; frees them all with the tree
     FileNode* root;
     int totalNodes;
     int maxDepth;
+    bool keepSortedIndex;
+    FileMetadataIndex<> sortedIndex; // B+-tree backing displaySortedFiles
+    
+    // Depth is tracked incrementally, so this is O(1)
+    static int calculateDepth(FileNode* node) {
+        return node ? node->height : 0;
+    }
+    
+    static int subtreeCount(const FileNode* node) {
+        return node ? node->subtreeCount : 0;
+    }
+    
+    static long long subtreeSize(const FileNode* node) {
+        return node ? node->subtreeSize : 0;
+    }
+    
+    // Recomputes a node's aggregates from its children in O(1)
+    static void updateAggregates(FileNode* node) {
+        const FileNode* l = node->left;
+        const FileNode* r = node->right;
+        node->height = 1 + max(calculateDepth(node->left), calculateDepth(node->right));
+        node->subtreeCount = 1 + subtreeCount(l) + subtreeCount(r);
+        node->subtreeSize = node->fileSize + subtreeSize(l) + subtreeSize(r);
+        for (int t = 0; t < FILE_TYPE_COUNT; t++) {
+            node->typeCounts[t] = (t == node->typeId) + (l ? l->typeCounts[t] : 0) + (r ? r->typeCounts[t] : 0);
+        }
+    }
     
-    // Helper function to calculate depth
-    int calculateDepth(FileNode* node) {
-        if (!node) return 0;
-        return 1 + max(calculateDepth(node->left), calculateDepth(node->right));
+    static FileNode* rotateRight(FileNode* y) {
+        FileNode* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        updateAggregates(y);
+        updateAggregates(x);
+        return x;
+    }
+    
+    static FileNode* rotateLeft(FileNode* x) {
+        FileNode* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        updateAggregates(x);
+        updateAggregates(y);
+        return y;
+    }
+    
+    // Restores the AVL invariant (child heights differ by at most 1) at node
+    static FileNode* rebalance(FileNode* node) {
+        updateAggregates(node);
+        int balance = calculateDepth(node->left) - calculateDepth(node->right);
+        if (balance > 1) {
+            if (calculateDepth(node->left->left) < calculateDepth(node->left->right))
+                node->left = rotateLeft(node->left);   // left-right case
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            if (calculateDepth(node->right->right) < calculateDepth(node->right->left))
+                node->right = rotateRight(node->right); // right-left case
+            return rotateLeft(node);
+        }
+        return node;
+    }
+    
+    // Unlinks the leftmost node of a subtree into minNode; returns the rebalanced remainder
+    static FileNode* detachMin(FileNode* node, FileNode*& minNode) {
+        if (!node->left) {
+            minNode = node;
+            return node->right;
+        }
+        node->left = detachMin(node->left, minNode);
+        return rebalance(node);
+    }
+    
+    // Total KB of files with name < key (or <= key when inclusive)
+    long long sizeBefore(const string& key, bool inclusive) const {
+        long long total = 0;
+        const FileNode* node = root;
+        while (node) {
+            if (node->fileName < key || (inclusive && node->fileName == key)) {
+                total += subtreeSize(node->left) + node->fileSize;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return total;
     }
     
     // Helper function for tree visualization
     void printTree(FileNode* node, string prefix = "", bool isLast = true, int depth = 0) {
-        if (!node) return;
+        struct Frame {
+            FileNode* node;
+            string prefix;
+            bool isLast;
+            int depth;
+        };
+        vector<Frame> stack;
+        if (node) stack.push_back({node, prefix, isLast, depth});
         
-        if (depth > maxDepth) maxDepth = depth;
+        while (!stack.empty()) {
+            Frame frame = std::move(stack.back());
+            stack.pop_back();
+            FileNode* current = frame.node;
+            
+            if (frame.depth > maxDepth) maxDepth = frame.depth;
+            
+            cout << frame.prefix;
+            cout << (frame.isLast ? "└── " : "├── ");
+            
+            // Different icons for different file types
+            string icon = "📄";
+            if (current->fileType == "folder") icon = "📁";
+            else if (current->fileType == "image") icon = "🖼️";
+            else if (current->fileType == "video") icon = "🎥";
+            else if (current->fileType == "audio") icon = "🎵";
+            else if (current->fileType == "document") icon = "📝";
+            
+            cout << icon << " " << current->fileName;
+            if (current->fileSize > 0) cout << " (" << current->fileSize << " KB)";
+            cout << endl;
+            
+            string newPrefix = frame.prefix + (frame.isLast ? "    " : "│   ");
+            
+            // Children (left first for BST visualization): push right first so left pops first
+            if (current->right) stack.push_back({current->right, newPrefix, true, frame.depth + 1});
+            if (current->left) stack.push_back({current->left, newPrefix, !current->right, frame.depth + 1});
+        }
+    }
+
+public:
+    // 🧭 In-order iterator over any subtree, driven by an explicit stack of
+    // pending ancestors (at most the tree height) instead of recursion.
+    class const_iterator {
+        vector<const FileNode*> stack;
         
-        cout << prefix;
-        cout << (isLast ? "└── " : "├── ");
+        void pushLeftSpine(const FileNode* node) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+        }
         
-        // Different icons for different file types
-        string icon = "📄";
-        if (node->fileType == "folder") icon = "📁";
-        else if (node->fileType == "image") icon = "🖼️";
-        else if (node->fileType == "video") icon = "🎥";
-        else if (node->fileType == "audio") icon = "🎵";
-        else if (node->fileType == "document") icon = "📝";
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = FileNode;
+        using difference_type = ptrdiff_t;
+        using pointer = const FileNode*;
+        using reference = const FileNode&;
         
-        cout << icon << " " << node->fileName;
-        if (node->fileSize > 0) cout << " (" << node->fileSize << " KB)";
-        cout << endl;
+        const_iterator() {}
+        explicit const_iterator(const FileNode* subtreeRoot) { pushLeftSpine(subtreeRoot); }
         
-        string newPrefix = prefix + (isLast ? "    " : "│   ");
+        reference operator*() const { return *stack.back(); }
+        pointer operator->() const { return stack.back(); }
         
-        // Print children (left first for BST visualization)
-        vector<FileNode*> children;
-        if (node->left) children.push_back(node->left);
-        if (node->right) children.push_back(node->right);
+        const_iterator& operator++() {
+            const FileNode* node = stack.back();
+            stack.pop_back();
+            pushLeftSpine(node->right);
+            return *this;
+        }
         
-        for (size_t i = 0; i < children.size(); i++) {
-            bool isLastChild = (i == children.size() - 1);
-            printTree(children[i], newPrefix, isLastChild, depth + 1);
+        bool operator==(const const_iterator& other) const {
+            return stack.empty() ? other.stack.empty()
+                                 : !other.stack.empty() && stack.back() == other.stack.back();
         }
-    }
-
-public:
-    FileSystemBST() : root(nullptr), totalNodes(0), maxDepth(0) {}
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+    
+    const_iterator begin() const { return const_iterator(root); }
+    const_iterator end() const { return const_iterator(); }
+    const FileNode* getRoot() const { return root; }
+    
+    explicit FileSystemBST(bool withSortedIndex = true)
+        : root(nullptr), totalNodes(0), maxDepth(0), keepSortedIndex(withSortedIndex) {}
     
-    // Insert a new file into BST (Alphabetical order)
-    FileNode* insert(FileNode* node, string fileName, string fileType = "file", int fileSize = 0) {
+    FileSystemBST(const FileSystemBST&) = delete;
+    FileSystemBST& operator=(const FileSystemBST&) = delete;
+    
+    // Insert a new file into BST (Alphabetical order), rebalancing on the way back up.
+    // Recursion depth is bounded by the AVL height, ~1.44 log2 n.
+    FileNode* insert(FileNode* node, const string& fileName, const string& fileType = "file", int fileSize = 0) {
         if (!node) {
             totalNodes++;
-            return new FileNode(fileName, fileType, fileSize);
+            return nodePool.create(fileName, fileType, fileSize);
         }
         
         if (fileName < node->fileName)
             node->left = insert(node->left, fileName, fileType, fileSize);
         else if (fileName > node->fileName)
             node->right = insert(node->right, fileName, fileType, fileSize);
+        else
+            return node; // duplicate name: keep the existing entry
         
-        return node;
+        return rebalance(node);
     }
     
     void insertFile(string fileName, string fileType = "file", int fileSize = 0) {
         root = insert(root, fileName, fileType, fileSize);
+        if (keepSortedIndex) sortedIndex.insert(fileName, fileType, fileSize);
+    }
+    
+    // Delete a file from BST, rebalancing and refreshing aggregates along the path
+    FileNode* remove(FileNode* node, const string& fileName, bool& removed) {
+        if (!node) return nullptr;
+        
+        if (fileName < node->fileName) {
+            node->left = remove(node->left, fileName, removed);
+        } else if (fileName > node->fileName) {
+            node->right = remove(node->right, fileName, removed);
+        } else {
+            removed = true;
+            totalNodes--;
+            FileNode* replacement;
+            if (!node->left || !node->right) {
+                replacement = node->left ? node->left : node->right;
+            } else {
+                // Two children: splice in the in-order successor
+                FileNode* successor = nullptr;
+                FileNode* rightRest = detachMin(node->right, successor);
+                successor->left = node->left;
+                successor->right = rightRest;
+                replacement = rebalance(successor);
+            }
+            nodePool.destroy(node);
+            return replacement;
+        }
+        return rebalance(node);
+    }
+    
+    bool removeFile(const string& fileName) {
+        bool removed = false;
+        root = remove(root, fileName, removed);
+        if (removed && keepSortedIndex) sortedIndex.remove(fileName);
+        return removed;
     }
     
     // Inorder traversal → sorted file view
     void inorderTraversal(FileNode* node) {
-        if (!node) return;
-        
-        inorderTraversal(node->left);
-        
-        string icon = "📄";
-        if (node->fileType == "folder") icon = "📁";
-        else if (node->fileType == "image") icon = "🖼️";
-        else if (node->fileType == "video") icon = "🎥";
-        else if (node->fileType == "audio") icon = "🎵";
-        else if (node->fileType == "document") icon = "📝";
-        
-        cout << icon << " " << left << setw(20) << node->fileName;
-        cout << " | " << left << setw(10) << node->fileType;
-        if (node->fileSize > 0) cout << " | " << right << setw(8) << node->fileSize << " KB";
-        cout << endl;
-        
-        inorderTraversal(node->right);
+        for (const_iterator it(node); it != const_iterator(); ++it) {
+            printFileRow(it->fileName, it->fileType, it->fileSize);
+        }
     }
     
-    // Search for a file with timing
-    bool searchFile(FileNode* node, string key, int& comparisons) {
-        comparisons++;
-        
-        if (!node) return false;
-        if (node->fileName == key) return true;
-        
-        if (key < node->fileName) 
-            return searchFile(node->left, key, comparisons);
-        else
-            return searchFile(node->right, key, comparisons);
+    // Sorted visit without output
+    template <typename Visitor>
+    void forEachSorted(Visitor fn) const {
+        for (const FileNode& node : *this) fn(node.fileName, node.fileType, node.fileSize);
+    }
+    
+    // Search for a file (iterative: no call stack growth)
+    bool searchFile(FileNode* node, const string& key, int& comparisons) {
+        while (true) {
+            comparisons++;
+            
+            if (!node) return false;
+            if (node->fileName == key) return true;
+            
+            node = (key < node->fileName) ? node->left : node->right;
+        }
     }
     
-    // Count total files by type
+    bool contains(const string& key) {
+        int comparisons = 0;
+        return searchFile(root, key, comparisons);
+    }
+    
+    int size() const { return totalNodes; }
+    int height() const { return calculateDepth(root); }
+    
+    // Count total files by type: O(1) for tracked types, full traversal otherwise
     void countByType(FileNode* node, string type, int& count) {
         if (!node) return;
         
-        if (node->fileType == type) count++;
-        countByType(node->left, type, count);
-        countByType(node->right, type, count);
+        int t = fileTypeIndex(type);
+        if (t >= 0) {
+            count += node->typeCounts[t];
+            return;
+        }
+        for (const_iterator it(node); it != const_iterator(); ++it) {
+            if (it->fileType == type) count++;
+        }
     }
     
-    // Calculate total storage used
+    // Calculate total storage used (maintained per subtree, O(1))
     long long calculateTotalSize(FileNode* node) {
-        if (!node) return 0;
-        
-        return node->fileSize + 
-               calculateTotalSize(node->left) + 
-               calculateTotalSize(node->right);
+        return subtreeSize(node);
+    }
+    
+    // k-th file in alphabetical order (1-based), nullptr if out of range. O(log n)
+    const FileNode* selectFile(int k) const {
+        const FileNode* node = root;
+        while (node) {
+            int leftCount = subtreeCount(node->left);
+            if (k <= leftCount) {
+                node = node->left;
+            } else if (k == leftCount + 1) {
+                return node;
+            } else {
+                k -= leftCount + 1;
+                node = node->right;
+            }
+        }
+        return nullptr;
+    }
+    
+    // Alphabetical position of a file (1-based), 0 if absent. O(log n)
+    int rankOf(const string& fileName) const {
+        int before = 0;
+        const FileNode* node = root;
+        while (node) {
+            if (fileName < node->fileName) {
+                node = node->left;
+            } else if (fileName > node->fileName) {
+                before += subtreeCount(node->left) + 1;
+                node = node->right;
+            } else {
+                return before + subtreeCount(node->left) + 1;
+            }
+        }
+        return 0;
+    }
+    
+    // Total KB of files whose names fall in [fromName, toName]. O(log n)
+    long long sizeInRange(const string& fromName, const string& toName) const {
+        if (toName < fromName) return 0;
+        return sizeBefore(toName, true) - sizeBefore(fromName, false);
     }
     
     void displaySortedFiles() {
-        cout << "\n🗂️ Files in Alphabetical Order (Inorder Traversal):\n";
+        cout << "\n🗂️ Files in Alphabetical Order (" << (keepSortedIndex ? "B+-tree leaf scan" : "Inorder Traversal") << "):\n";
         cout << "┌────────────────────┬────────────┬──────────┐\n";
         cout << "│ File Name          │ Type       │ Size     │\n";
         cout << "├────────────────────┼────────────┼──────────┤\n";
-        inorderTraversal(root);
+        if (keepSortedIndex) sortedIndex.forEachSorted(printFileRow);
+        else inorderTraversal(root);
         cout << "└────────────────────┴────────────┴──────────┘\n";
     }
     
@@ -198,9 +981,8 @@ public:
         cout << "├── Tree depth: " << calculateDepth(root) << endl;
         cout << "├── Total storage: " << calculateTotalSize(root) << " KB" << endl;
         
-        // Count by file type
-        vector<string> types = {"folder", "document", "image", "video", "audio", "file"};
-        for (const string& type : types) {
+        // Count by file type (each lookup reads the root's aggregates)
+        for (const string& type : FILE_TYPES) {
             int count = 0;
             countByType(root, type, count);
             if (count > 0) {
@@ -211,7 +993,1274 @@ public:
     }
 };
 
-int main() {
+// 📡 ConcurrentFileIndex: read-optimized ordered map for many readers, one writer
+//
+// The tree is an AVL tree of immutable published nodes. The single writer
+// never modifies a node readers can see: it copies the root-to-leaf path it
+// changes (path copying) into a private working version, and publishes a whole
+// batch of updates with one atomic root store. Nodes created inside the
+// current batch are still private, so later updates in the same batch modify
+// them in place instead of copying the path again.
+// Readers pin the current epoch in their own slot, load the root and read
+// without any lock or retry. Every node the writer replaces is retired
+// with the epoch of the batch that replaced it, and is freed only once
+// every pinned reader slot shows a later epoch (epoch-based reclamation).
+class ConcurrentFileIndex {
+public:
+    struct Node {
+        string fileName;
+        string fileType;
+        int fileSize; // in KB
+        int height;
+        int subtreeCount;
+        uint64_t batch; // batch that created the node; mutable while it is the current one
+        const Node* left;
+        const Node* right;
+    };
+    
+    static constexpr int MAX_READERS = 64;
+    
+private:
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0}; // 0 = not reading
+    };
+    
+    struct RetiredBatch {
+        uint64_t epoch;
+        vector<Node*> nodes;
+    };
+    
+    NodePool<Node> nodePool; // touched by the writer only
+    atomic<const Node*> published{nullptr};
+    atomic<uint64_t> globalEpoch{1};
+    ReaderSlot readers[MAX_READERS];
+    atomic<int> registeredReaders{0};
+    
+    // Writer-only state
+    const Node* working = nullptr;
+    uint64_t currentBatch = 1;
+    size_t pendingUpdates = 0;
+    vector<Node*> retiredNow;
+    deque<RetiredBatch> limbo;
+    size_t reclaimedNodes = 0;
+    
+    static int height(const Node* n) { return n ? n->height : 0; }
+    static int count(const Node* n) { return n ? n->subtreeCount : 0; }
+    
+    static void update(Node* n) {
+        n->height = 1 + max(height(n->left), height(n->right));
+        n->subtreeCount = 1 + count(n->left) + count(n->right);
+    }
+    
+    // Returns a node of the working version that may be modified: the node
+    // itself if this batch created it, otherwise a copy (the original is retired)
+    Node* own(const Node* n) {
+        if (n->batch == currentBatch) return const_cast<Node*>(n);
+        Node* copy = nodePool.create(*n);
+        copy->batch = currentBatch;
+        retire(n);
+        return copy;
+    }
+    
+    void retire(const Node* n) {
+        if (n->batch == currentBatch) nodePool.destroy(const_cast<Node*>(n)); // never published
+        else retiredNow.push_back(const_cast<Node*>(n));
+    }
+    
+    Node* rotateRight(Node* y) {
+        Node* x = own(y->left);
+        y->left = x->right;
+        x->right = y;
+        update(y);
+        update(x);
+        return x;
+    }
+    
+    Node* rotateLeft(Node* x) {
+        Node* y = own(x->right);
+        x->right = y->left;
+        y->left = x;
+        update(x);
+        update(y);
+        return y;
+    }
+    
+    Node* rebalance(Node* n) {
+        update(n);
+        int balance = height(n->left) - height(n->right);
+        if (balance > 1) {
+            if (height(n->left->left) < height(n->left->right)) n->left = rotateLeft(own(n->left));
+            return rotateRight(n);
+        }
+        if (balance < -1) {
+            if (height(n->right->right) < height(n->right->left)) n->right = rotateRight(own(n->right));
+            return rotateLeft(n);
+        }
+        return n;
+    }
+    
+    const Node* insert(const Node* n, const string& name, const string& type, int size) {
+        if (!n) return nodePool.create(Node{name, type, size, 1, 1, currentBatch, nullptr, nullptr});
+        Node* m = own(n);
+        if (name < m->fileName) m->left = insert(m->left, name, type, size);
+        else if (name > m->fileName) m->right = insert(m->right, name, type, size);
+        else {
+            m->fileType = type;
+            m->fileSize = size;
+            return m;
+        }
+        return rebalance(m);
+    }
+    
+    // Unlinks the leftmost node of a subtree (already owned) into minNode
+    const Node* detachMin(const Node* n, Node*& minNode) {
+        Node* m = own(n);
+        if (!m->left) {
+            minNode = m;
+            return m->right;
+        }
+        m->left = detachMin(m->left, minNode);
+        return rebalance(m);
+    }
+    
+    const Node* remove(const Node* n, const string& name, bool& removed) {
+        if (!n) return nullptr;
+        if (name < n->fileName) {
+            const Node* child = remove(n->left, name, removed);
+            if (!removed) return n;
+            Node* m = own(n);
+            m->left = child;
+            return rebalance(m);
+        }
+        if (name > n->fileName) {
+            const Node* child = remove(n->right, name, removed);
+            if (!removed) return n;
+            Node* m = own(n);
+            m->right = child;
+            return rebalance(m);
+        }
+        removed = true;
+        const Node* left = n->left;
+        const Node* right = n->right;
+        retire(n);
+        if (!left || !right) return left ? left : right;
+        Node* successor = nullptr;
+        const Node* rest = detachMin(right, successor);
+        successor->left = left;
+        successor->right = rest;
+        return rebalance(successor);
+    }
+    
+    void reclaim() {
+        uint64_t oldestPinned = UINT64_MAX;
+        int n = registeredReaders.load();
+        for (int i = 0; i < n; i++) {
+            uint64_t e = readers[i].epoch.load();
+            if (e) oldestPinned = min(oldestPinned, e);
+        }
+        while (!limbo.empty() && limbo.front().epoch < oldestPinned) {
+            for (Node* node : limbo.front().nodes) nodePool.destroy(node);
+            reclaimedNodes += limbo.front().nodes.size();
+            limbo.pop_front();
+        }
+    }
+    
+public:
+    ConcurrentFileIndex() = default;
+    ConcurrentFileIndex(const ConcurrentFileIndex&) = delete;
+    ConcurrentFileIndex& operator=(const ConcurrentFileIndex&) = delete;
+    
+    // Each reading thread registers once and passes its id to ReadGuard
+    // (a CAS loop, so a refused registration leaves the count at MAX_READERS)
+    int registerReader() {
+        int id = registeredReaders.load();
+        do {
+            if (id >= MAX_READERS) throw length_error("ConcurrentFileIndex: too many readers");
+        } while (!registeredReaders.compare_exchange_weak(id, id + 1));
+        return id;
+    }
+    
+    // 🔒-free read section: the version seen at construction stays valid
+    // (and unchanged) until the guard is destroyed
+    class ReadGuard {
+        ConcurrentFileIndex& index;
+        int reader;
+        const Node* root;
+        
+    public:
+        ReadGuard(ConcurrentFileIndex& owner, int readerId) : index(owner), reader(readerId) {
+            index.readers[reader].epoch.store(index.globalEpoch.load());
+            root = index.published.load();
+        }
+        ~ReadGuard() { index.readers[reader].epoch.store(0, memory_order_release); }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        
+        const Node* find(const string& name) const {
+            const Node* n = root;
+            while (n && n->fileName != name) n = name < n->fileName ? n->left : n->right;
+            return n;
+        }
+        
+        int size() const { return count(root); }
+        
+        template <typename Visitor>
+        void forEachSorted(Visitor fn) const {
+            vector<const Node*> stack;
+            for (const Node* n = root; n || !stack.empty();) {
+                for (; n; n = n->left) stack.push_back(n);
+                n = stack.back();
+                stack.pop_back();
+                fn(*n);
+                n = n->right;
+            }
+        }
+    };
+    
+    // Writer side (one thread): stage updates, then publish them together
+    void insertFile(const string& name, const string& type = "file", int size = 0) {
+        working = insert(working, name, type, size);
+        pendingUpdates++;
+    }
+    
+    bool removeFile(const string& name) {
+        bool removed = false;
+        working = remove(working, name, removed);
+        pendingUpdates += removed;
+        return removed;
+    }
+    
+    // Makes every staged update visible at once, then frees what no reader can reach
+    void publish() {
+        if (pendingUpdates == 0) return;
+        published.store(working);
+        uint64_t retiredAt = globalEpoch.fetch_add(1);
+        if (!retiredNow.empty()) limbo.push_back({retiredAt, std::move(retiredNow)});
+        retiredNow.clear();
+        currentBatch++;
+        pendingUpdates = 0;
+        reclaim();
+    }
+    
+    size_t liveNodes() const { return nodePool.size(); }
+    size_t awaitingReclaim() const {
+        size_t total = retiredNow.size();
+        for (const RetiredBatch& batch : limbo) total += batch.nodes.size();
+        return total;
+    }
+    size_t reclaimed() const { return reclaimedNodes; }
+};
+
+// 📸 PersistentFileTree: AVL tree with O(1) snapshots via structural sharing
+//
+// Nodes are reference counted (one count per parent pointer or root holding
+// them). An update walks down from the root and makes each node on its path
+// unique before changing it: a node whose count is 1 belongs to this tree
+// alone and is modified in place, a shared one is copied first (path
+// copying). snapshot() just adds a reference to the root, so right after a
+// snapshot the next update copies its O(log n) path, and later updates only
+// copy where they meet nodes the snapshot still shares. Counts are atomic,
+// so snapshots can be read and dropped on other threads.
+class PersistentFileTree {
+public:
+    struct Node {
+        string fileName;
+        string fileType;
+        int fileSize; // in KB
+        int height;
+        int subtreeCount;
+        long long subtreeSize;
+        mutable atomic<int> refs;
+        Node* left;
+        Node* right;
+        
+        Node(string name, string type, int size)
+            : fileName(std::move(name)), fileType(std::move(type)), fileSize(size), height(1),
+              subtreeCount(1), subtreeSize(size), refs(1), left(nullptr), right(nullptr) {}
+        Node(const Node& other)
+            : fileName(other.fileName), fileType(other.fileType), fileSize(other.fileSize),
+              height(other.height), subtreeCount(other.subtreeCount), subtreeSize(other.subtreeSize),
+              refs(1), left(other.left), right(other.right) {}
+    };
+    
+    static atomic<long long> liveNodes; // across all trees, for memory reporting
+    
+private:
+    Node* root = nullptr;
+    
+    static Node* retain(Node* n) {
+        if (n) n->refs.fetch_add(1, memory_order_relaxed);
+        return n;
+    }
+    
+    // Drops one reference; frees the node and, iteratively, whatever only it held
+    static void release(Node* n) {
+        vector<Node*> pending;
+        while (n || !pending.empty()) {
+            if (!n) {
+                n = pending.back();
+                pending.pop_back();
+            }
+            if (n->refs.fetch_sub(1, memory_order_acq_rel) != 1) {
+                n = nullptr;
+                continue;
+            }
+            if (n->right) pending.push_back(n->right);
+            Node* next = n->left;
+            delete n;
+            liveNodes.fetch_sub(1, memory_order_relaxed);
+            n = next;
+        }
+    }
+    
+    static Node* makeNode(const string& name, const string& type, int size) {
+        liveNodes.fetch_add(1, memory_order_relaxed);
+        return new Node(name, type, size);
+    }
+    
+    // Takes an owned reference and returns an owned node no one else can see
+    static Node* makeUnique(Node* n) {
+        if (n->refs.load(memory_order_acquire) == 1) return n;
+        Node* copy = new Node(*n);
+        liveNodes.fetch_add(1, memory_order_relaxed);
+        retain(copy->left);
+        retain(copy->right);
+        release(n);
+        return copy;
+    }
+    
+    static const Node* findNode(const Node* n, const string& name) {
+        while (n && n->fileName != name) n = name < n->fileName ? n->left : n->right;
+        return n;
+    }
+    
+    static int height(const Node* n) { return n ? n->height : 0; }
+    static int count(const Node* n) { return n ? n->subtreeCount : 0; }
+    static long long kilobytes(const Node* n) { return n ? n->subtreeSize : 0; }
+    
+    static void update(Node* n) {
+        n->height = 1 + max(height(n->left), height(n->right));
+        n->subtreeCount = 1 + count(n->left) + count(n->right);
+        n->subtreeSize = n->fileSize + kilobytes(n->left) + kilobytes(n->right);
+    }
+    
+    static Node* rotateRight(Node* y) {
+        Node* x = makeUnique(y->left);
+        y->left = x->right;
+        x->right = y;
+        update(y);
+        update(x);
+        return x;
+    }
+    
+    static Node* rotateLeft(Node* x) {
+        Node* y = makeUnique(x->right);
+        x->right = y->left;
+        y->left = x;
+        update(x);
+        update(y);
+        return y;
+    }
+    
+    static Node* rebalance(Node* n) {
+        update(n);
+        int balance = height(n->left) - height(n->right);
+        if (balance > 1) {
+            if (height(n->left->left) < height(n->left->right)) n->left = rotateLeft(makeUnique(n->left));
+            return rotateRight(n);
+        }
+        if (balance < -1) {
+            if (height(n->right->right) < height(n->right->left)) n->right = rotateRight(makeUnique(n->right));
+            return rotateLeft(n);
+        }
+        return n;
+    }
+    
+    static Node* insert(Node* n, const string& name, const string& type, int size) {
+        if (!n) return makeNode(name, type, size);
+        n = makeUnique(n);
+        if (name < n->fileName) n->left = insert(n->left, name, type, size);
+        else if (name > n->fileName) n->right = insert(n->right, name, type, size);
+        else {
+            n->fileType = type;
+            n->fileSize = size;
+        }
+        return rebalance(n);
+    }
+    
+    static Node* detachMin(Node* n, Node*& minNode) {
+        n = makeUnique(n);
+        if (!n->left) {
+            minNode = n;
+            Node* rest = n->right;
+            n->right = nullptr;
+            return rest;
+        }
+        n->left = detachMin(n->left, minNode);
+        return rebalance(n);
+    }
+    
+    // The name must be present (checked by removeFile, so misses copy nothing)
+    static Node* remove(Node* n, const string& name) {
+        n = makeUnique(n);
+        if (name < n->fileName) {
+            n->left = remove(n->left, name);
+            return rebalance(n);
+        }
+        if (name > n->fileName) {
+            n->right = remove(n->right, name);
+            return rebalance(n);
+        }
+        Node* left = n->left;
+        Node* right = n->right;
+        n->left = n->right = nullptr;
+        release(n);
+        if (!left || !right) return left ? left : right;
+        Node* successor = nullptr;
+        Node* rest = detachMin(right, successor);
+        successor->left = left;
+        successor->right = rest;
+        return rebalance(successor);
+    }
+    
+    static Node* clone(const Node* n) {
+        if (!n) return nullptr;
+        Node* copy = new Node(*n);
+        liveNodes.fetch_add(1, memory_order_relaxed);
+        copy->left = clone(n->left); // depth is O(log n)
+        copy->right = clone(n->right);
+        return copy;
+    }
+    
+public:
+    // A read-only version of the tree at the moment snapshot() was called
+    class Snapshot {
+        Node* root;
+        
+    public:
+        explicit Snapshot(Node* sharedRoot = nullptr) : root(sharedRoot) {}
+        Snapshot(const Snapshot& other) : root(retain(other.root)) {}
+        Snapshot(Snapshot&& other) noexcept : root(other.root) { other.root = nullptr; }
+        Snapshot& operator=(Snapshot other) {
+            swap(root, other.root);
+            return *this;
+        }
+        ~Snapshot() { if (root) release(root); }
+        
+        const Node* find(const string& name) const { return findNode(root, name); }
+        
+        int size() const { return count(root); }
+        long long totalSize() const { return kilobytes(root); }
+        
+        template <typename Visitor>
+        void forEachSorted(Visitor fn) const {
+            vector<const Node*> stack;
+            for (const Node* n = root; n || !stack.empty();) {
+                for (; n; n = n->left) stack.push_back(n);
+                n = stack.back();
+                stack.pop_back();
+                fn(*n);
+                n = n->right;
+            }
+        }
+    };
+    
+    PersistentFileTree() = default;
+    PersistentFileTree(const PersistentFileTree&) = delete;
+    PersistentFileTree& operator=(const PersistentFileTree&) = delete;
+    ~PersistentFileTree() { if (root) release(root); }
+    
+    void insertFile(const string& name, const string& type = "file", int size = 0) {
+        root = insert(root, name, type, size);
+    }
+    
+    bool removeFile(const string& name) {
+        if (!findNode(root, name)) return false;
+        root = remove(root, name);
+        return true;
+    }
+    
+    // O(1): shares the whole current tree
+    Snapshot snapshot() const { return Snapshot(retain(root)); }
+    
+    // The naive alternative: an unshared copy of every node
+    Snapshot deepCopy() const { return Snapshot(clone(root)); }
+    
+    int size() const { return count(root); }
+    int treeHeight() const { return height(root); }
+};
+
+atomic<long long> PersistentFileTree::liveNodes{0};
+
+// Times sorted vs shuffled insertion of n files. Sorted input is the worst case for
+// an unbalanced BST (height n); the AVL tree keeps both runs at ~log2 n height.
+vector<string> makeBenchmarkNames(int n) {
+    vector<string> names(n);
+    char buffer[32];
+    for (int i = 0; i < n; i++) {
+        snprintf(buffer, sizeof(buffer), "file%09d.dat", i);
+        names[i] = buffer;
+    }
+    return names;
+}
+
+void benchmarkInsertionOrder(int n) {
+    cout << "=== ⏱️ Insertion Order Benchmark (n = " << n << ") ===\n\n";
+    
+    vector<string> names = makeBenchmarkNames(n);
+    vector<string> shuffled = names;
+    mt19937 rng(42);
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+    
+    const int lookups = min(n, 1000000);
+    vector<string> queries(lookups);
+    for (int i = 0; i < lookups; i++) queries[i] = names[rng() % n];
+    
+    auto runCase = [&](const string& label, const vector<string>& order) {
+        FileSystemBST fs(false);
+        auto start = high_resolution_clock::now();
+        for (const string& name : order) fs.insertFile(name, "file", 1);
+        auto mid = high_resolution_clock::now();
+        int hits = 0;
+        for (const string& q : queries) hits += fs.contains(q);
+        auto end = high_resolution_clock::now();
+        
+        double insertMs = duration_cast<microseconds>(mid - start).count() / 1000.0;
+        double searchNs = duration_cast<nanoseconds>(end - mid).count() / (double)lookups;
+        cout << "📥 " << left << setw(8) << label << right
+             << " insert: " << fixed << setprecision(1) << setw(9) << insertMs << " ms"
+             << " | height: " << setw(3) << fs.height()
+             << " | search: " << setw(6) << searchNs << " ns/lookup"
+             << " (" << hits << "/" << lookups << " found)\n";
+    };
+    
+    runCase("sorted", names);
+    runCase("random", shuffled);
+    cout << "📐 log2(n) = " << fixed << setprecision(1) << log2((double)n)
+         << ", AVL bound 1.44·log2(n) = " << 1.44 * log2((double)n + 2) << "\n";
+}
+
+// Keeps benchmark scans from being optimized away
+volatile size_t benchmarkSink = 0;
+
+// Compares the AVL FileSystemBST with FileMetadataIndex B+-trees of several node
+// sizes on random-order insert, random lookups and a full sorted scan.
+void benchmarkMetadataIndex(int n) {
+    cout << "\n=== 🗄️ B+-tree vs AVL Benchmark (n = " << n << ") ===\n\n";
+    
+    vector<string> names = makeBenchmarkNames(n);
+    mt19937 rng(7);
+    shuffle(names.begin(), names.end(), rng);
+    const int lookups = min(n, 1000000);
+    vector<string> queries(lookups);
+    for (int i = 0; i < lookups; i++) queries[i] = names[rng() % n];
+    
+    auto report = [&](const string& label, double insertNs, double searchNs, double scanNs,
+                      int hits, const string& shape) {
+        cout << "📊 " << left << setw(22) << label << right << fixed << setprecision(1)
+             << " insert " << setw(7) << insertNs << " ns"
+             << " | search " << setw(7) << searchNs << " ns"
+             << " | scan " << setw(5) << scanNs << " ns/file"
+             << " | " << shape << (hits == lookups ? "" : " ⚠️ missing keys") << "\n";
+    };
+    
+    {
+        FileSystemBST fs(false);
+        auto t0 = high_resolution_clock::now();
+        for (const string& name : names) fs.insertFile(name, "file", 1);
+        auto t1 = high_resolution_clock::now();
+        int hits = 0;
+        for (const string& q : queries) hits += fs.contains(q);
+        auto t2 = high_resolution_clock::now();
+        fs.forEachSorted([](const string& name, const string&, int size) { benchmarkSink += name.size() + size; });
+        auto t3 = high_resolution_clock::now();
+        report("AVL FileSystemBST", duration_cast<nanoseconds>(t1 - t0).count() / (double)n,
+               duration_cast<nanoseconds>(t2 - t1).count() / (double)lookups,
+               duration_cast<nanoseconds>(t3 - t2).count() / (double)n, hits,
+               "height " + to_string(fs.height()));
+    }
+    
+    auto runIndex = [&](auto& index, const string& label) {
+        auto t0 = high_resolution_clock::now();
+        for (const string& name : names) index.insert(name, "file", 1);
+        auto t1 = high_resolution_clock::now();
+        int hits = 0;
+        for (const string& q : queries) hits += index.contains(q);
+        auto t2 = high_resolution_clock::now();
+        index.forEachSorted([](string_view name, const string&, int size) { benchmarkSink += name.size() + size; });
+        auto t3 = high_resolution_clock::now();
+        report(label, duration_cast<nanoseconds>(t1 - t0).count() / (double)n,
+               duration_cast<nanoseconds>(t2 - t1).count() / (double)lookups,
+               duration_cast<nanoseconds>(t3 - t2).count() / (double)n, hits,
+               "height " + to_string(index.height()) + ", fanout " + to_string(index.leafFanout()) +
+               "/" + to_string(index.innerFanout()) + ", " +
+               to_string(index.memoryBytes() / (1024 * 1024)) + " MB");
+    };
+    
+    { FileMetadataIndex<4> index(true);   runIndex(index, "B+ 4 lines, prefix"); }
+    { FileMetadataIndex<8> index(true);   runIndex(index, "B+ 8 lines, prefix"); }
+    { FileMetadataIndex<8> index(false);  runIndex(index, "B+ 8 lines, no prefix"); }
+    { FileMetadataIndex<16> index(true);  runIndex(index, "B+ 16 lines, prefix"); }
+}
+
+// Per-node new/delete vs NodePool<FileNode>: allocation throughput, slot reuse
+// after random churn, and locality of a chain of nodes walked in allocation order.
+void benchmarkNodePool(int n) {
+    cout << "\n=== 🧱 NodePool vs new/delete (n = " << n << ", " << sizeof(FileNode)
+         << "-byte FileNode) ===\n\n";
+    
+    vector<string> names = makeBenchmarkNames(n);
+    vector<FileNode*> nodes(n);
+    auto nsPerNode = [&](high_resolution_clock::time_point a, high_resolution_clock::time_point b) {
+        return duration_cast<nanoseconds>(b - a).count() / (double)n;
+    };
+    cout << fixed << setprecision(1);
+    
+    // 1. Allocation throughput
+    {
+        auto t0 = high_resolution_clock::now();
+        for (int i = 0; i < n; i++) nodes[i] = new FileNode(names[i], "file", i);
+        auto t1 = high_resolution_clock::now();
+        for (int i = 0; i < n; i++) delete nodes[i];
+        auto t2 = high_resolution_clock::now();
+        cout << "⚡ new/delete:        alloc " << setw(6) << nsPerNode(t0, t1) << " ns | free "
+             << setw(6) << nsPerNode(t1, t2) << " ns per node\n";
+    }
+    {
+        NodePool<FileNode> pool;
+        auto t0 = high_resolution_clock::now();
+        for (int i = 0; i < n; i++) nodes[i] = pool.create(names[i], "file", i);
+        auto t1 = high_resolution_clock::now();
+        for (int i = 0; i < n; i++) pool.destroy(nodes[i]);
+        auto t2 = high_resolution_clock::now();
+        for (int i = 0; i < n; i++) nodes[i] = pool.create(names[i], "file", i);
+        auto t3 = high_resolution_clock::now();
+        pool.clear();
+        auto t4 = high_resolution_clock::now();
+        cout << "⚡ NodePool:          alloc " << setw(6) << nsPerNode(t0, t1) << " ns | free "
+             << setw(6) << nsPerNode(t1, t2) << " ns | reuse " << setw(6) << nsPerNode(t2, t3)
+             << " ns | bulk clear " << setw(5) << nsPerNode(t3, t4) << " ns per node\n";
+    }
+    
+    // 2. Churn: free a random half, allocate replacements, check slot reuse
+    {
+        NodePool<FileNode> pool;
+        for (int i = 0; i < n; i++) nodes[i] = pool.create(names[i], "file", i);
+        size_t slabsBefore = pool.slabCount();
+        mt19937 rng(11);
+        vector<int> order(n);
+        for (int i = 0; i < n; i++) order[i] = i;
+        shuffle(order.begin(), order.end(), rng);
+        for (int i = 0; i < n / 2; i++) pool.destroy(nodes[order[i]]);
+        double holes = pool.utilization();
+        for (int i = 0; i < n / 2; i++) nodes[order[i]] = pool.create(names[order[i]], "file", 0);
+        cout << "♻️ Churn (free 50%, refill): utilization " << setprecision(0) << holes * 100
+             << "% → " << pool.utilization() * 100 << "%, slabs " << slabsBefore << " → "
+             << pool.slabCount() << " (" << pool.reservedBytes() / (1024 * 1024) << " MB)\n"
+             << setprecision(1);
+    }
+    
+    // 3. Locality: walk a chain linked in allocation order; name strings are
+    // heap-allocated too, so per-node new interleaves nodes with string buffers.
+    auto walk = [&](FileNode* head, const string& label) {
+        vector<long long> strides;
+        for (int i = 1; i < n; i++) {
+            strides.push_back(llabs((long long)((uintptr_t)nodes[i] - (uintptr_t)nodes[i - 1])));
+        }
+        nth_element(strides.begin(), strides.begin() + strides.size() / 2, strides.end());
+        long long medianStride = strides.empty() ? 0 : strides[strides.size() / 2];
+        auto t0 = high_resolution_clock::now();
+        long long total = 0;
+        for (int pass = 0; pass < 5; pass++) {
+            for (FileNode* node = head; node; node = node->right) total += node->fileSize;
+        }
+        auto t1 = high_resolution_clock::now();
+        benchmarkSink += total;
+        cout << "🧭 " << left << setw(18) << label << right << " walk " << setw(5)
+             << nsPerNode(t0, t1) / 5 << " ns/node | median address stride "
+             << medianStride << " bytes\n";
+    };
+    {
+        for (int i = 0; i < n; i++) {
+            nodes[i] = new FileNode(names[i], "file", i);
+            if (i > 0) nodes[i - 1]->right = nodes[i];
+        }
+        walk(nodes[0], "new/delete chain:");
+        for (int i = 0; i < n; i++) delete nodes[i];
+    }
+    {
+        NodePool<FileNode> pool;
+        for (int i = 0; i < n; i++) {
+            nodes[i] = pool.create(names[i], "file", i);
+            if (i > 0) nodes[i - 1]->right = nodes[i];
+        }
+        walk(nodes[0], "NodePool chain:");
+    }
+    
+    // 4. Threads: every thread allocates and frees its share of the nodes,
+    // through new/delete, one pool behind a mutex, or its own threadLocal() pool
+    int threads = max(2u, thread::hardware_concurrency());
+    auto perThread = [&](auto&& allocate, auto&& release) {
+        auto t0 = high_resolution_clock::now();
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                int from = (int)((long long)n * t / threads), to = (int)((long long)n * (t + 1) / threads);
+                for (int round = 0; round < 2; round++) {
+                    for (int i = from; i < to; i++) nodes[i] = allocate(i);
+                    for (int i = from; i < to; i++) release(nodes[i]);
+                }
+            });
+        }
+        for (thread& worker : workers) worker.join();
+        return nsPerNode(t0, high_resolution_clock::now()) / 2;
+    };
+    double newNs = perThread([&](int i) { return new FileNode(names[i], "file", i); },
+                             [](FileNode* node) { delete node; });
+    NodePool<FileNode> shared;
+    mutex sharedLock;
+    double sharedNs = perThread([&](int i) { lock_guard<mutex> guard(sharedLock); return shared.create(names[i], "file", i); },
+                                [&](FileNode* node) { lock_guard<mutex> guard(sharedLock); shared.destroy(node); });
+    double localNs = perThread([&](int i) { return NodePool<FileNode>::threadLocal().create(names[i], "file", i); },
+                               [](FileNode* node) { NodePool<FileNode>::threadLocal().destroy(node); });
+    cout << "🧵 " << threads << " threads, alloc + free: new/delete " << setw(6) << newNs << " ns | shared pool + mutex "
+         << setw(6) << sharedNs << " ns | threadLocal() pools " << setw(6) << localNs << " ns per node\n";
+}
+
+// 🛰️ DirectoryCrawler: parallel scanner for a real directory tree
+// (same crawler as Implementation/recursion_algorithms.cpp)
+//
+// Every directory is one task on a shared queue served by a worker pool; a
+// task's subdirectories are queued in one batch when it finishes. On Linux a
+// task opens its directory once, reads entries in 64 KB batches with
+// getdents64 and stats files relative to the directory fd with statx, asking
+// only for type and size and not forcing a sync with remote filesystems.
+// Symlinks are listed as files and never followed. Other platforms fall back
+// to std::filesystem::directory_iterator per directory.
+class DirectoryCrawler {
+public:
+    struct Directory {
+        int id;
+        int parent;     // -1 for the root
+        string name;    // last path component (the root keeps the path as given)
+        vector<string> files;
+        vector<unsigned long long> fileSizes; // bytes, 0 when sizes are not collected
+        vector<int> subdirectories;           // ids, always greater than this id
+    };
+    
+    struct Stats {
+        long long directories = 0;
+        long long files = 0;
+        unsigned long long bytes = 0;
+        long long errors = 0; // directories that could not be opened
+        double seconds = 0;
+    };
+    
+private:
+    struct Task {
+        string path;
+        Directory* directory;
+    };
+    
+    struct Entry {
+        string name;
+        bool isDirectory;
+        unsigned long long size;
+    };
+    
+    vector<unique_ptr<Directory>> directoryList;
+    mutex registryLock;
+    mutex queueLock;
+    condition_variable queueReady;
+    deque<Task> queue;
+    int activeTasks = 0;
+    bool collectSizes;
+    bool rootUnreadable = false;
+    atomic<long long> errorCount{0};
+    double elapsed = 0;
+    
+    bool listDirectory(const string& path, vector<Entry>& out) {
+#ifdef __linux__
+        struct LinuxDirent64 {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return false;
+        thread_local vector<char> buffer(64 * 1024);
+        while (true) {
+            long bytes = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if (bytes == 0) break;
+            if (bytes < 0) { // a read error, not the end: report it rather than a short listing
+                close(fd);
+                return false;
+            }
+            for (long offset = 0; offset < bytes;) {
+                const LinuxDirent64* entry = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+                offset += entry->d_reclen;
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
+                
+                unsigned char type = entry->d_type;
+                unsigned long long size = 0;
+                if (type == DT_UNKNOWN || (collectSizes && type == DT_REG)) {
+                    struct statx info;
+                    if (statx(fd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC,
+                              STATX_TYPE | STATX_SIZE, &info) == 0) {
+                        if (S_ISDIR(info.stx_mode)) type = DT_DIR;
+                        else if (S_ISREG(info.stx_mode)) type = DT_REG;
+                        if (type == DT_REG) size = info.stx_size;
+                    }
+                }
+                out.push_back({name, type == DT_DIR, size});
+            }
+        }
+        close(fd);
+        return true;
+#else
+        error_code ec;
+        filesystem::directory_iterator it(path, filesystem::directory_options::skip_permission_denied, ec);
+        if (ec) return false;
+        for (const auto& entry : it) {
+            bool isDirectory = entry.is_directory(ec) && !entry.is_symlink(ec);
+            unsigned long long size = 0;
+            if (collectSizes && !isDirectory && entry.is_regular_file(ec)) size = entry.file_size(ec);
+            out.push_back({entry.path().filename().string(), isDirectory, size});
+        }
+        return true;
+#endif
+    }
+    
+    void scan(const Task& task, vector<Task>& subtasks) {
+        vector<Entry> entries;
+        if (!listDirectory(task.path, entries)) {
+            errorCount.fetch_add(1, memory_order_relaxed);
+            if (task.directory->id == 0) rootUnreadable = true;
+            return;
+        }
+        Directory& dir = *task.directory;
+        vector<string> subdirectoryNames;
+        for (Entry& entry : entries) {
+            if (entry.isDirectory) {
+                subdirectoryNames.push_back(std::move(entry.name));
+            } else {
+                dir.files.push_back(std::move(entry.name));
+                dir.fileSizes.push_back(entry.size);
+            }
+        }
+        if (subdirectoryNames.empty()) return;
+        
+        string prefix = task.path.back() == '/' ? task.path : task.path + "/";
+        lock_guard<mutex> guard(registryLock);
+        for (string& name : subdirectoryNames) {
+            directoryList.push_back(make_unique<Directory>());
+            Directory* child = directoryList.back().get();
+            child->id = (int)directoryList.size() - 1;
+            child->parent = dir.id;
+            dir.subdirectories.push_back(child->id);
+            subtasks.push_back({prefix + name, child});
+            child->name = std::move(name);
+        }
+    }
+    
+    void workerLoop() {
+        unique_lock<mutex> lock(queueLock);
+        while (true) {
+            queueReady.wait(lock, [this] { return !queue.empty() || activeTasks == 0; });
+            if (queue.empty()) break; // nothing queued and nothing running: done
+            
+            Task task = std::move(queue.front());
+            queue.pop_front();
+            activeTasks++;
+            lock.unlock();
+            
+            vector<Task> subtasks;
+            scan(task, subtasks);
+            
+            lock.lock();
+            activeTasks--;
+            for (Task& sub : subtasks) queue.push_back(std::move(sub));
+            if (!subtasks.empty() || activeTasks == 0) queueReady.notify_all();
+        }
+    }
+    
+public:
+    explicit DirectoryCrawler(bool withSizes = true) : collectSizes(withSizes) {}
+    
+    // Scans everything below rootPath; returns false if the root itself cannot be read
+    bool crawl(const string& rootPath, int threads) {
+        auto start = high_resolution_clock::now();
+        directoryList.clear();
+        directoryList.push_back(make_unique<Directory>());
+        directoryList[0]->id = 0;
+        directoryList[0]->parent = -1;
+        directoryList[0]->name = rootPath;
+        errorCount.store(0);
+        rootUnreadable = false;
+        queue.push_back({rootPath, directoryList[0].get()});
+        activeTasks = 0;
+        
+        vector<thread> pool;
+        for (int i = 1; i < max(1, threads); i++) pool.emplace_back([this] { workerLoop(); });
+        workerLoop();
+        for (thread& t : pool) t.join();
+        
+        elapsed = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+        return !rootUnreadable;
+    }
+    
+    const vector<unique_ptr<Directory>>& directories() const { return directoryList; }
+    
+    Stats stats() const {
+        Stats s;
+        s.directories = (long long)directoryList.size();
+        for (const auto& dir : directoryList) {
+            s.files += (long long)dir->files.size();
+            for (unsigned long long size : dir->fileSizes) s.bytes += size;
+        }
+        s.errors = errorCount.load();
+        s.seconds = elapsed;
+        return s;
+    }
+};
+
+
+// Maps a file name to one of the FILE_TYPES buckets by extension
+string fileTypeFromName(const string& name) {
+    size_t dot = name.rfind('.');
+    if (dot == string::npos || dot == 0) return "file";
+    string ext = name.substr(dot + 1);
+    for (char& c : ext) c = (char)tolower((unsigned char)c);
+    static const vector<pair<string, vector<string>>> groups = {
+        {"image", {"jpg", "jpeg", "png", "gif", "bmp", "svg", "webp", "ico"}},
+        {"video", {"mp4", "mkv", "avi", "mov", "webm"}},
+        {"audio", {"mp3", "wav", "flac", "ogg", "m4a"}},
+        {"document", {"pdf", "doc", "docx", "txt", "md", "xlsx", "pptx", "odt", "rst", "html"}},
+    };
+    for (const auto& group : groups) {
+        if (find(group.second.begin(), group.second.end(), ext) != group.second.end()) return group.first;
+    }
+    return "file";
+}
+
+// Crawls a real path and loads every file and folder into a FileSystemBST,
+// keyed by its path relative to the scan root
+void runDirectoryScan(const string& path, int threads) {
+    cout << "=== 🛰️ Loading FileSystemBST from " << path << " (" << threads << " threads) ===\n\n";
+    
+    DirectoryCrawler crawler(true);
+    if (!crawler.crawl(path, threads)) {
+        cout << "❌ Cannot open '" << path << "'\n";
+        return;
+    }
+    DirectoryCrawler::Stats stats = crawler.stats();
+    
+    auto start = high_resolution_clock::now();
+    FileSystemBST fileSystem;
+    const auto& dirs = crawler.directories();
+    vector<string> relativePath(dirs.size());
+    for (const auto& dir : dirs) {
+        if (dir->parent >= 0) {
+            const string& parentPath = relativePath[dir->parent];
+            relativePath[dir->id] = parentPath.empty() ? dir->name : parentPath + "/" + dir->name;
+            fileSystem.insertFile(relativePath[dir->id], "folder");
+        }
+        const string prefix = relativePath[dir->id].empty() ? "" : relativePath[dir->id] + "/";
+        for (size_t i = 0; i < dir->files.size(); i++) {
+            int sizeKB = (int)min<unsigned long long>((dir->fileSizes[i] + 1023) / 1024, INT32_MAX);
+            fileSystem.insertFile(prefix + dir->files[i], fileTypeFromName(dir->files[i]), sizeKB);
+        }
+    }
+    double buildMs = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    
+    double seconds = max(stats.seconds, 1e-9);
+    cout << fixed << setprecision(1);
+    cout << "📊 Crawl: " << stats.seconds * 1000 << " ms, " << (stats.files + stats.directories) / seconds
+         << " entries/s (" << stats.files << " files, " << stats.directories << " dirs";
+    if (stats.errors) cout << ", " << stats.errors << " unreadable";
+    cout << ")\n";
+    cout << "🌳 BST + index build: " << buildMs << " ms\n";
+    
+    fileSystem.showStatistics();
+    if (fileSystem.size() <= 40) fileSystem.displaySortedFiles();
+}
+
+// Read latency while one writer applies heavy updates: ConcurrentFileIndex
+// (lock-free reads, batched publication) vs FileSystemBST behind a shared_mutex
+void benchmarkConcurrentIndex(int n, int readerThreads) {
+    const int batchSize = 64;
+    const auto runTime = milliseconds(1000);
+    cout << "\n=== 📡 Concurrent Reads During Updates (" << n << " files, " << readerThreads
+         << " readers + 1 writer, batches of " << batchSize << ", hardware threads: "
+         << thread::hardware_concurrency() << ") ===\n";
+    
+    vector<string> names = makeBenchmarkNames(n);
+    struct Result {
+        vector<long long> latencies; // ns, all readers
+        long long reads = 0;
+        long long updates = 0;
+    };
+    
+    // Runs readers and one writer for runTime; read(name, reader) and
+    // writeBatch(rng) are the structure-specific parts
+    auto run = [&](auto&& prepareReader, auto&& read, auto&& writeBatch) {
+        Result result;
+        atomic<bool> stop{false};
+        atomic<size_t> hits{0}; // readers must not share benchmarkSink
+        vector<vector<long long>> perReader(readerThreads);
+        vector<thread> threads;
+        for (int r = 0; r < readerThreads; r++) {
+            threads.emplace_back([&, r] {
+                int readerId = prepareReader();
+                mt19937 rng(1000 + r);
+                vector<long long>& samples = perReader[r];
+                samples.reserve(1 << 20);
+                size_t found = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    const string& name = names[rng() % n];
+                    auto t0 = steady_clock::now();
+                    found += read(name, readerId);
+                    samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - t0).count());
+                }
+                hits += found;
+            });
+        }
+        thread writer([&] {
+            mt19937 rng(7);
+            while (!stop.load(memory_order_relaxed)) result.updates += writeBatch(rng);
+        });
+        this_thread::sleep_for(runTime);
+        stop.store(true);
+        writer.join();
+        for (thread& t : threads) t.join();
+        benchmarkSink += hits.load();
+        for (auto& samples : perReader) {
+            result.reads += samples.size();
+            result.latencies.insert(result.latencies.end(), samples.begin(), samples.end());
+        }
+        sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    };
+    
+    auto percentile = [](const vector<long long>& sorted, double p) {
+        return sorted.empty() ? 0LL : sorted[min(sorted.size() - 1, (size_t)(p / 100.0 * sorted.size()))];
+    };
+    auto report = [&](const string& label, const Result& r) {
+        double seconds = duration_cast<duration<double>>(runTime).count();
+        cout << "├── " << left << setw(30) << label << right << fixed << setprecision(1)
+             << " reads " << setw(6) << r.reads / seconds / 1e6 << " M/s | updates " << setw(6)
+             << r.updates / seconds / 1e3 << " k/s | p50 " << percentile(r.latencies, 50)
+             << " ns, p99 " << percentile(r.latencies, 99) << " ns, p99.9 " << percentile(r.latencies, 99.9)
+             << " ns, max " << (r.latencies.empty() ? 0 : r.latencies.back() / 1000) << " us\n";
+    };
+    
+    // Each batch inserts or removes random names, so the tree stays ~half full
+    ConcurrentFileIndex index;
+    for (int i = 0; i < n; i += 2) index.insertFile(names[i], "file", i % 4096);
+    index.publish();
+    Result rcu = run([&] { return index.registerReader(); },
+                     [&](const string& name, int reader) {
+                         ConcurrentFileIndex::ReadGuard guard(index, reader);
+                         return guard.find(name) != nullptr;
+                     },
+                     [&](mt19937& rng) {
+                         for (int k = 0; k < batchSize; k++) {
+                             int i = rng() % n;
+                             if (rng() & 1) index.insertFile(names[i], "file", i % 4096);
+                             else index.removeFile(names[i]);
+                         }
+                         index.publish();
+                         return batchSize;
+                     });
+    
+    FileSystemBST locked(false);
+    shared_mutex lock;
+    for (int i = 0; i < n; i += 2) locked.insertFile(names[i], "file", i % 4096);
+    Result rw = run([] { return 0; },
+                    [&](const string& name, int) {
+                        shared_lock<shared_mutex> guard(lock);
+                        return locked.contains(name);
+                    },
+                    [&](mt19937& rng) {
+                        unique_lock<shared_mutex> guard(lock);
+                        for (int k = 0; k < batchSize; k++) {
+                            int i = rng() % n;
+                            if (rng() & 1) locked.insertFile(names[i], "file", i % 4096);
+                            else locked.removeFile(names[i]);
+                        }
+                        return batchSize;
+                    });
+    
+    report("ConcurrentFileIndex (RCU)", rcu);
+    report("FileSystemBST + shared_mutex", rw);
+    cout << "└── Reclamation: " << index.reclaimed() << " nodes freed, " << index.awaitingReclaim()
+         << " awaiting readers, " << index.liveNodes() << " live\n";
+}
+
+// O(1) snapshots vs deep copies: cost to take, memory per update while
+// snapshots are alive, and read speed of an old version
+void benchmarkSnapshots(int n) {
+    cout << "\n=== 📸 Persistent Snapshots vs Deep Copies (" << n << " files) ===\n";
+    cout << fixed << setprecision(2);
+    
+    vector<string> names = makeBenchmarkNames(n);
+    mt19937 rng(42);
+    shuffle(names.begin(), names.end(), rng);
+    PersistentFileTree tree;
+    for (int i = 0; i < n; i++) tree.insertFile(names[i], "file", i % 4096);
+    
+    // Approximate bytes per node: the node plus its name when it does not fit SSO
+    const size_t nodeBytes = sizeof(PersistentFileTree::Node) + (names[0].size() > 15 ? names[0].size() + 1 : 0);
+    auto live = [] { return PersistentFileTree::liveNodes.load(); };
+    auto timeNs = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        fn();
+        return (double)duration_cast<nanoseconds>(high_resolution_clock::now() - t0).count();
+    };
+    
+    // Taking a version
+    const int takes = 1000;
+    double snapshotNs = timeNs([&] {
+        for (int i = 0; i < takes; i++) {
+            PersistentFileTree::Snapshot s = tree.snapshot();
+            benchmarkSink += s.size();
+        }
+    }) / takes;
+    long long before = live();
+    PersistentFileTree::Snapshot copy;
+    double copyNs = timeNs([&] { copy = tree.deepCopy(); });
+    long long copyNodes = live() - before;
+    cout << "⏱️ Taking a version:\n";
+    cout << "├── snapshot():  " << setw(12) << snapshotNs << " ns, 0 extra nodes\n";
+    cout << "└── deepCopy():  " << setw(12) << copyNs / 1e6 << " ms, " << copyNodes << " extra nodes (~"
+         << copyNodes * nodeBytes / 1048576 << " MB)\n";
+    
+    // Memory per update under three snapshot policies
+    const int updates = 10000;
+    auto updateBatch = [&](auto&& afterEach) {
+        for (int i = 0; i < updates; i++) {
+            tree.insertFile(names[rng() % n], "file", (int)(rng() % 4096)); // overwrite an existing file
+            afterEach();
+        }
+    };
+    cout << "\n📦 Extra nodes per update (" << updates << " updates, tree height " << tree.treeHeight() << "):\n";
+    before = live();
+    updateBatch([] {});
+    cout << "├── No snapshots alive:        " << setw(8) << (double)(live() - before) / updates << " nodes/update\n";
+    {
+        PersistentFileTree::Snapshot held = tree.snapshot();
+        before = live();
+        updateBatch([] {});
+        cout << "├── One snapshot held:         " << setw(8) << (double)(live() - before) / updates
+             << " nodes/update (paths diverge once, then are private)\n";
+    }
+    {
+        vector<PersistentFileTree::Snapshot> versions;
+        versions.reserve(updates);
+        before = live();
+        updateBatch([&] { versions.push_back(tree.snapshot()); });
+        double perUpdate = (double)(live() - before) / updates;
+        cout << "└── Snapshot after every update:" << setw(7) << perUpdate << " nodes/update (~"
+             << (long long)(perUpdate * nodeBytes) << " bytes, vs " << (long long)n * nodeBytes / 1024
+             << " KB for a deep copy)\n";
+    }
+    
+    // Reading an old version while the live tree keeps changing
+    PersistentFileTree::Snapshot old = tree.snapshot();
+    copy = tree.deepCopy();
+    int oldSize = old.size();
+    for (int i = 0; i < 100000; i++) {
+        const string& name = names[rng() % n];
+        if (rng() & 1) tree.removeFile(name);
+        else tree.insertFile(name + ".new", "file", 1);
+    }
+    const int lookups = 200000;
+    vector<int> probes(lookups);
+    for (int& p : probes) p = rng() % n;
+    auto lookupRate = [&](const PersistentFileTree::Snapshot& version) {
+        double ns = timeNs([&] {
+            for (int p : probes) benchmarkSink += version.find(names[p]) != nullptr;
+        });
+        return lookups / ns * 1e3;
+    };
+    auto scanMs = [&](const PersistentFileTree::Snapshot& version) {
+        return timeNs([&] { version.forEachSorted([](const PersistentFileTree::Node& f) { benchmarkSink += f.fileSize; }); }) / 1e6;
+    };
+    cout << "\n📖 Reading the old version after 100000 more live updates (size still "
+         << old.size() << (old.size() == oldSize ? " ✅" : " ⚠️ changed") << ", live tree " << tree.size() << "):\n";
+    cout << "├── Snapshot:  " << setw(8) << lookupRate(old) << " M lookups/s | sorted scan " << setw(8) << scanMs(old) << " ms\n";
+    cout << "└── Deep copy: " << setw(8) << lookupRate(copy) << " M lookups/s | sorted scan " << setw(8) << scanMs(copy) << " ms\n";
+}
+
+// Reference recursive in-order walk for the traversal benchmark
+long long recursiveSizeSum(const FileNode* node) {
+    if (!node) return 0;
+    long long total = recursiveSizeSum(node->left);
+    total += node->fileSize;
+    return total + recursiveSizeSum(node->right);
+}
+
+// Recursive vs iterator-based in-order traversal of the same tree
+void benchmarkTraversal(int n) {
+    cout << "\n=== 🧭 Recursive vs Iterative In-order (n = " << n << ") ===\n\n";
+    
+    vector<string> names = makeBenchmarkNames(n);
+    mt19937 rng(5);
+    shuffle(names.begin(), names.end(), rng);
+    FileSystemBST fs(false);
+    for (int i = 0; i < n; i++) fs.insertFile(names[i], "file", i % 1000);
+    
+    auto timePerNode = [&](auto&& walk) {
+        auto t0 = high_resolution_clock::now();
+        long long total = 0;
+        for (int rep = 0; rep < 5; rep++) total += walk();
+        auto t1 = high_resolution_clock::now();
+        benchmarkSink += total;
+        return duration_cast<nanoseconds>(t1 - t0).count() / 5.0 / n;
+    };
+    double recursive = timePerNode([&] { return recursiveSizeSum(fs.getRoot()); });
+    double iterator = timePerNode([&] {
+        long long total = 0;
+        for (const FileNode& node : fs) total += node.fileSize;
+        return total;
+    });
+    
+    cout << fixed << setprecision(1);
+    cout << "🔁 recursive:      " << setw(6) << recursive << " ns/node\n";
+    cout << "🧭 const_iterator: " << setw(6) << iterator << " ns/node (stack depth <= height "
+         << fs.height() << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && string(argv[1]) == "--scan") {
+        int threads = argc > 3 ? atoi(argv[3]) : (int)max(4u, thread::hardware_concurrency());
+        runDirectoryScan(argv[2], max(1, threads));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--concurrent") {
+        int n = argc > 2 ? atoi(argv[2]) : 1000000;
+        int readers = argc > 3 ? atoi(argv[3]) : (int)max(4u, thread::hardware_concurrency());
+        benchmarkConcurrentIndex(n > 0 ? n : 1000000, max(1, min(readers, ConcurrentFileIndex::MAX_READERS)));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--snapshots") {
+        int n = argc > 2 ? atoi(argv[2]) : 1000000;
+        benchmarkSnapshots(n > 0 ? n : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        int n = argc > 2 ? atoi(argv[2]) : 1000000;
+        if (n <= 0) n = 1000000;
+        benchmarkInsertionOrder(n);
+        benchmarkMetadataIndex(n);
+        benchmarkNodePool(n);
+        benchmarkTraversal(n);
+        return 0;
+    }
+    
     cout << "=== 🌳 File System Organization (Binary Search Tree) ===\n\n";
     
     FileSystemBST fileSystem;
@@ -256,12 +2305,25 @@ int main() {
         fileSystem.performSearch(query);
     }
     
+    // Order statistics from the subtree aggregates
+    cout << "\n🔢 Order Statistics (O(log n) via subtree counts):\n";
+    const FileNode* fifth = fileSystem.selectFile(5);
+    if (fifth) cout << "├── 5th file alphabetically: " << fifth->fileName << endl;
+    cout << "├── Rank of 'Resume.pdf': " << fileSystem.rankOf("Resume.pdf") << " of " << fileSystem.size() << endl;
+    cout << "└── Storage of files in [\"M\", \"S\"]: " << fileSystem.sizeInRange("M", "S") << " KB" << endl;
+    
+    cout << "\n🗑️ Removing 'Movie.mp4' and 'Setup.exe'...\n";
+    fileSystem.removeFile("Movie.mp4");
+    fileSystem.removeFile("Setup.exe");
+    fileSystem.showStatistics();
+    
     cout << "\n🧩 Key Concepts Demonstrated:\n";
     cout << "• 📊 BST maintains sorted order automatically\n";
-    cout << "• 🔍 Search time is O(log n) on average, O(n) worst case\n";
+    cout << "• 🔍 Search time is O(log n) guaranteed by AVL rebalancing\n";
     cout << "• 🌳 Tree structure reflects hierarchical organization\n";
-    cout << "• ⚖️ Balance affects performance significantly\n";
-    cout << "• 📁 Real file systems use more advanced trees (B-trees)\n\n";
+    cout << "• ⚖️ Rotations keep sorted insertions from degrading to O(n)\n";
+    cout << "• 📁 Real file systems use more advanced trees (B-trees)\n";
+    cout << "• ➕ Augmented nodes turn statistics into O(1) reads and enable rank/select\n\n";
     
     cout << "💡 Real-world Applications:\n";
     cout << "• File system directories and indexing\n";
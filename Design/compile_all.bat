@@ -25,7 +25,7 @@ echo.
 
 :: Compile Stack Text Editor
 echo [1/3] Compiling Stack Text Editor (Undo/Redo System)...
-g++ %FLAGS% -o bin\stack_text_editor.exe stack_text_editor.cpp
+g++ %FLAGS% -pthread -o bin\stack_text_editor.exe stack_text_editor.cpp
 if %errorlevel% neq 0 (
     echo ERROR: Failed to compile stack_text_editor.cpp
     pause
@@ -35,7 +35,7 @@ echo      ✓ stack_text_editor.exe created successfully
 
 :: Compile Queue Bank System  
 echo [2/3] Compiling Queue Bank System (Customer Service)...
-g++ %FLAGS% -o bin\queue_bank_system.exe queue_bank_system.cpp
+g++ %FLAGS% -pthread -o bin\queue_bank_system.exe queue_bank_system.cpp
 if %errorlevel% neq 0 (
     echo ERROR: Failed to compile queue_bank_system.cpp
     pause
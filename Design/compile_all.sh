@@ -24,7 +24,7 @@ echo
 
 # Compile Stack Text Editor
 echo "[1/3] Compiling Stack Text Editor (Undo/Redo System)..."
-if g++ $FLAGS -o bin/stack_text_editor stack_text_editor.cpp; then
+if g++ $FLAGS -pthread -o bin/stack_text_editor stack_text_editor.cpp; then
     echo "     ✓ stack_text_editor created successfully"
 else
     echo "ERROR: Failed to compile stack_text_editor.cpp"
@@ -33,7 +33,7 @@ fi
 
 # Compile Queue Bank System
 echo "[2/3] Compiling Queue Bank System (Customer Service)..."
-if g++ $FLAGS -o bin/queue_bank_system queue_bank_system.cpp; then
+if g++ $FLAGS -pthread -o bin/queue_bank_system queue_bank_system.cpp; then
     echo "     ✓ queue_bank_system created successfully"
 else
     echo "ERROR: Failed to compile queue_bank_system.cpp"
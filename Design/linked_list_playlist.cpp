@@ -19,6 +19,10 @@
 #include <iomanip>
 #include <vector>
 #include <random>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 using namespace std;
 using namespace std::chrono;
 
@@ -42,8 +46,120 @@ struct Song {
     }
 };
 
+// 🧱 NodePool<T>: slab allocator for the playlist's Song nodes
+//
+// Songs come out of aligned 64 KB slabs instead of one heap block each, so a
+// playlist built in order is laid out mostly sequentially. Removed songs go
+// on a free list and are handed out again first; clear() uses each slab's
+// live bitmap to destroy the remaining songs and releases every slab at once.
+template <typename T, size_t SlabBytes = 64 * 1024>
+class NodePool {
+    static_assert((SlabBytes & (SlabBytes - 1)) == 0, "slab size must be a power of two");
+    
+    union Slot {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    
+    static constexpr size_t MAX_SLOTS = SlabBytes / sizeof(Slot);
+    static constexpr size_t BITMAP_WORDS = (MAX_SLOTS + 63) / 64;
+    
+    struct SlabHeader {
+        size_t liveCount;
+        uint64_t live[BITMAP_WORDS];
+    };
+    
+    static constexpr size_t HEADER_BYTES = (sizeof(SlabHeader) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    
+public:
+    static constexpr size_t SLOTS_PER_SLAB = (SlabBytes - HEADER_BYTES) / sizeof(Slot);
+    static_assert(SLOTS_PER_SLAB >= 8, "slab too small for this node type");
+    
+private:
+    vector<SlabHeader*> slabs;
+    Slot* freeList;
+    size_t bumpIndex; // next never-used slot in the newest slab
+    
+    static Slot* slotsOf(SlabHeader* slab) {
+        return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(slab) + HEADER_BYTES);
+    }
+    
+    static SlabHeader* slabOf(const void* p) {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(SlabBytes - 1));
+    }
+    
+    static size_t indexOf(SlabHeader* slab, const void* p) {
+        return static_cast<const Slot*>(p) - slotsOf(slab);
+    }
+    
+    Slot* takeSlot() {
+        if (freeList) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+        if (slabs.empty() || bumpIndex == SLOTS_PER_SLAB) {
+            void* memory = ::operator new(SlabBytes, align_val_t(SlabBytes));
+            SlabHeader* slab = new (memory) SlabHeader();
+            slabs.push_back(slab);
+            bumpIndex = 0;
+        }
+        return slotsOf(slabs.back()) + bumpIndex++;
+    }
+    
+public:
+    NodePool() : freeList(nullptr), bumpIndex(0) {}
+    ~NodePool() { clear(); }
+    
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = takeSlot();
+        T* node = new (slot->storage) T(std::forward<Args>(args)...);
+        SlabHeader* slab = slabOf(slot);
+        size_t i = indexOf(slab, slot);
+        slab->live[i / 64] |= uint64_t(1) << (i % 64);
+        slab->liveCount++;
+        return node;
+    }
+    
+    void destroy(T* node) {
+        if (!node) return;
+        node->~T();
+        SlabHeader* slab = slabOf(node);
+        size_t i = indexOf(slab, node);
+        slab->live[i / 64] &= ~(uint64_t(1) << (i % 64));
+        slab->liveCount--;
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+    
+    // Destroys every live node and returns all slabs in one pass
+    void clear() {
+        for (SlabHeader* slab : slabs) {
+            if (!is_trivially_destructible<T>::value && slab->liveCount > 0) {
+                Slot* slots = slotsOf(slab);
+                for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                    for (uint64_t bits = slab->live[w]; bits; bits &= bits - 1) {
+                        reinterpret_cast<T*>(slots[w * 64 + __builtin_ctzll(bits)].storage)->~T();
+                    }
+                }
+            }
+            slab->~SlabHeader();
+            ::operator delete(slab, align_val_t(SlabBytes));
+        }
+        slabs.clear();
+        freeList = nullptr;
+        bumpIndex = 0;
+    }
+};
+
 class MusicPlaylist {
 private:
+    NodePool<Song> songPool; // owns every Song node
     Song* head;
     Song* tail;
     Song* current;
@@ -62,19 +178,16 @@ public:
         cout << "🎧 Created Playlist: \"" << playlistName << "\"\n\n";
     }
 
-    ~MusicPlaylist() {
-        // Clean up memory
-        while (head) {
-            Song* temp = head;
-            head = head->next;
-            delete temp;
-        }
-    }
+    // songPool releases every remaining Song in one pass
+    ~MusicPlaylist() = default;
+    
+    MusicPlaylist(const MusicPlaylist&) = delete;
+    MusicPlaylist& operator=(const MusicPlaylist&) = delete;
 
     void addSong(const string& title, const string& artist = "Unknown Artist", 
                  const string& album = "Unknown Album", int duration = 180, 
                  const string& genre = "Pop") {
-        Song* newSong = new Song(title, artist, album, duration, genre);
+        Song* newSong = songPool.create(title, artist, album, duration, genre);
         
         if (!head) {
             // First song in playlist
@@ -134,7 +247,7 @@ public:
         cout << "🗑️ Removed: \"" << songToRemove->title << "\" by " << songToRemove->artist << "\n";
         playHistory.push_back("REMOVED: " + songToRemove->title);
         
-        delete songToRemove;
+        songPool.destroy(songToRemove);
         showPlaylistStatus();
     }
 
@@ -6,10 +6,17 @@
  * for fair service distribution. First-come, first-served principle ensures equity.
  * 
  * Time Complexity:
- * - Enqueue (join queue): O(1)
- * - Dequeue (serve customer): O(1)
- * - Display queue: O(n)
+ * - Enqueue (join queue): O(log n)
+ * - Dequeue (serve customer): O(log n)
+ * - Change priority / cancel by token: O(log n)
+ * - Display queue: O(n log n)
  * Space Complexity: O(n) where n is number of customers
+ *
+ * Run with --bench [customers] to time the scheduler with 10^7 queued customers,
+ * --threads [kiosks] [tellers] [customers] for the multi-threaded branch
+ * (build with -pthread), --simulate [tellers] [arrivals/hour] [hours] for a
+ * discrete-event run of the branch, or --sweep [fewest] [most] [arrivals/hour]
+ * [hours] to compare staffing levels in parallel.
  */
 
 #include <iostream>
@@ -19,6 +26,17 @@
 #include <iomanip>
 #include <vector>
 #include <random>
+#include <unordered_map>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <optional>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cmath>
 using namespace std;
 using namespace std::chrono;
 
@@ -37,89 +55,442 @@ struct Customer {
     }
 };
 
+// 🎯 ServiceScheduler: every priority class in one indexed 4-ary min-heap
+//
+// Each waiting item gets a token (its arrival sequence number) and a rank:
+//   rank = priority                                   (strict priority), or
+//   rank = (priority - 1) * agingSpan + token         (with aging),
+// and items are served in (rank, token) order. Priority 1 is the most urgent
+// and up to MAX_CLASSES classes can be used. With aging, an item of class p is
+// served before any class-1 item that arrives more than (p - 1) * agingSpan
+// tokens after it, so a lower class cannot starve.
+// Heap slots hold only the key and an entry index, and a 4-ary heap is half
+// as deep as a binary one; items stay put in a slab with a free list, a
+// parallel array records each entry's heap slot, and a hash map from the
+// waiting tokens to their entries finds an item by token, so lookup state is
+// O(n) however long an item waits. Push, pop, priority change and cancel by
+// token are O(log n).
+template <typename Item>
+class ServiceScheduler {
+public:
+    static constexpr int MAX_CLASSES = 64;
+    
+private:
+    struct Slot {
+        uint64_t rank;
+        uint64_t token;
+        uint32_t entry;
+    };
+    struct Entry {
+        Item item;
+        int priority;
+    };
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr size_t ARITY = 4;
+    
+    vector<Slot> heap;
+    vector<Entry> entries;
+    vector<uint32_t> slotOfEntry; // apart from the items, so sifting touches only small arrays
+    vector<uint32_t> freeEntries;
+    unordered_map<uint64_t, uint32_t> entryOfToken; // waiting tokens only
+    uint64_t nextSequence = 1;
+    uint64_t agingSpan;           // 0 = strict priority
+    vector<size_t> classSizes;    // waiting items per priority
+    
+    uint64_t rankOf(int priority, uint64_t token) const {
+        return agingSpan ? (uint64_t)(priority - 1) * agingSpan + token : (uint64_t)priority;
+    }
+    
+    static bool before(const Slot& a, const Slot& b) {
+        return a.rank != b.rank ? a.rank < b.rank : a.token < b.token;
+    }
+    
+    void place(size_t at, const Slot& slot) {
+        heap[at] = slot;
+        slotOfEntry[slot.entry] = (uint32_t)at;
+    }
+    
+    void siftUp(size_t at) {
+        Slot moving = heap[at];
+        while (at > 0) {
+            size_t parent = (at - 1) / ARITY;
+            if (!before(moving, heap[parent])) break;
+            place(at, heap[parent]);
+            at = parent;
+        }
+        place(at, moving);
+    }
+    
+    void siftDown(size_t at) {
+        Slot moving = heap[at];
+        while (true) {
+            size_t first = at * ARITY + 1;
+            if (first >= heap.size()) break;
+            size_t best = first, last = min(first + ARITY, heap.size());
+            for (size_t child = first + 1; child < last; child++) {
+                if (before(heap[child], heap[best])) best = child;
+            }
+            if (!before(heap[best], moving)) break;
+            place(at, heap[best]);
+            at = best;
+        }
+        place(at, moving);
+    }
+    
+    void validate(int priority) const {
+        if (priority < 1 || priority > MAX_CLASSES) {
+            throw invalid_argument("priority must be between 1 and " + to_string(MAX_CLASSES));
+        }
+    }
+    
+    uint32_t entryOf(uint64_t token) const {
+        auto found = entryOfToken.find(token);
+        return found == entryOfToken.end() ? NONE : found->second;
+    }
+    
+    // Takes the item out of heap slot `at` and frees its entry
+    Item removeAt(size_t at) {
+        Slot removed = heap[at];
+        Entry& entry = entries[removed.entry];
+        Item item = std::move(entry.item);
+        classSizes[entry.priority]--;
+        slotOfEntry[removed.entry] = NONE;
+        freeEntries.push_back(removed.entry);
+        
+        entryOfToken.erase(removed.token);
+        
+        Slot last = heap.back();
+        heap.pop_back();
+        if (at < heap.size()) {
+            place(at, last);
+            if (at > 0 && before(last, heap[(at - 1) / ARITY])) siftUp(at);
+            else siftDown(at);
+        }
+        return item;
+    }
+    
+public:
+    explicit ServiceScheduler(uint64_t agingSpanTokens = 32) : agingSpan(agingSpanTokens) {}
+    
+    void reserve(size_t items) {
+        heap.reserve(items);
+        entries.reserve(items);
+        slotOfEntry.reserve(items);
+        entryOfToken.reserve(items);
+    }
+    
+    // Token the next push will get
+    uint64_t nextToken() const { return nextSequence; }
+    
+    uint64_t push(Item item, int priority) {
+        validate(priority);
+        uint64_t token = nextSequence++;
+        uint32_t entry;
+        if (freeEntries.empty()) {
+            entry = (uint32_t)entries.size();
+            entries.push_back({std::move(item), priority});
+            slotOfEntry.push_back(NONE);
+        } else {
+            entry = freeEntries.back();
+            freeEntries.pop_back();
+            entries[entry].item = std::move(item);
+            entries[entry].priority = priority;
+        }
+        entryOfToken.emplace(token, entry);
+        if ((size_t)priority >= classSizes.size()) classSizes.resize(priority + 1);
+        classSizes[priority]++;
+        heap.push_back({rankOf(priority, token), token, entry});
+        siftUp(heap.size() - 1);
+        return token;
+    }
+    
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    
+    // Next item to serve (the scheduler must not be empty)
+    const Item& top() const { return entries[heap.front().entry].item; }
+    int topPriority() const { return entries[heap.front().entry].priority; }
+    
+    Item pop() { return removeAt(0); }
+    
+    // Moves a waiting item to another class; it keeps its place in arrival order
+    bool changePriority(uint64_t token, int priority) {
+        validate(priority);
+        uint32_t index = entryOf(token);
+        if (index == NONE) return false;
+        Entry* entry = &entries[index];
+        classSizes[entry->priority]--;
+        if ((size_t)priority >= classSizes.size()) classSizes.resize(priority + 1);
+        classSizes[priority]++;
+        bool moreUrgent = rankOf(priority, token) < rankOf(entry->priority, token);
+        entry->priority = priority;
+        heap[slotOfEntry[index]].rank = rankOf(priority, token);
+        if (moreUrgent) siftUp(slotOfEntry[index]);
+        else siftDown(slotOfEntry[index]);
+        return true;
+    }
+    
+    // Removes a waiting item; empty if the token is not waiting
+    optional<Item> cancel(uint64_t token) {
+        if (entryOf(token) == NONE) return nullopt;
+        return removeAt(slotOfEntry[entryOf(token)]);
+    }
+    
+    // The waiting item with this token, or nullptr. Changing its priority
+    // must go through changePriority.
+    Item* find(uint64_t token) {
+        uint32_t entry = entryOf(token);
+        return entry == NONE ? nullptr : &entries[entry].item;
+    }
+    
+    // Re-ranks everything (O(n)) under a new aging span; 0 = strict priority
+    void setAgingSpan(uint64_t tokens) {
+        agingSpan = tokens;
+        for (Slot& slot : heap) slot.rank = rankOf(entries[slot.entry].priority, slot.token);
+        for (size_t i = heap.size() / ARITY + 1; i-- > 0;) {
+            if (i < heap.size()) siftDown(i);
+        }
+    }
+    
+    size_t classSize(int priority) const { return (size_t)priority < classSizes.size() ? classSizes[priority] : 0; }
+    int lowestClass() const { return (int)classSizes.size() - 1; }
+    
+    // Calls fn(item, priority, token) for every waiting item in service order
+    // (sorts a copy of the heap keys, so O(n log n))
+    template <typename Visitor>
+    void forEachInOrder(Visitor fn) const {
+        vector<Slot> order(heap);
+        sort(order.begin(), order.end(), before);
+        for (const Slot& slot : order) fn(entries[slot.entry].item, entries[slot.entry].priority, slot.token);
+    }
+    
+    size_t memoryBytes() const {
+        return heap.capacity() * sizeof(Slot) + entries.capacity() * sizeof(Entry)
+             + (slotOfEntry.capacity() + freeEntries.capacity()) * sizeof(uint32_t)
+             + entryOfToken.bucket_count() * sizeof(void*)
+             + entryOfToken.size() * (sizeof(pair<const uint64_t, uint32_t>) + sizeof(void*) + sizeof(size_t));
+    }
+};
+
+// 🔄 MpmcRing: bounded lock-free multi-producer/multi-consumer queue (Vyukov)
+//
+// Each cell carries a sequence number that says whose turn it is: a producer
+// may fill cell i when sequence == position, a consumer may empty it when
+// sequence == position + 1. A thread claims a position with one CAS on the
+// shared head or tail and then hands the cell over by storing the next
+// sequence, so there is no lock and a stalled thread only holds up its own
+// cell. Capacity is rounded up to a power of two.
+template <typename T>
+class MpmcRing {
+    struct alignas(64) Cell {
+        atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* item() { return reinterpret_cast<T*>(storage); }
+    };
+    
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos{0};
+    alignas(64) atomic<size_t> dequeuePos{0};
+    
+public:
+    explicit MpmcRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) cells[i].sequence.store(i, memory_order_relaxed);
+    }
+    
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+    
+    ~MpmcRing() {
+        while (tryPop()) {}
+    }
+    
+    // Moves from `item` only on success; false if the ring is full
+    bool tryPush(T& item) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t turn = (intptr_t)sequence - (intptr_t)pos;
+            if (turn == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    new (cell.storage) T(std::move(item));
+                    cell.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+    
+    optional<T> tryPop() {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t turn = (intptr_t)sequence - (intptr_t)(pos + 1);
+            if (turn == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    optional<T> item(std::move(*cell.item()));
+                    cell.item()->~T();
+                    cell.sequence.store(pos + mask + 1, memory_order_release);
+                    return item;
+                }
+            } else if (turn < 0) {
+                return nullopt;
+            } else {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Approximate under concurrent use
+    bool empty() const {
+        return dequeuePos.load(memory_order_acquire) >= enqueuePos.load(memory_order_acquire);
+    }
+};
+
+// 🔒 LockedQueue: the same bounded interface over a mutex-protected std::queue
+template <typename T>
+class LockedQueue {
+    mutex lock;
+    queue<T> items;
+    size_t capacity;
+    
+public:
+    explicit LockedQueue(size_t capacityLimit) : capacity(capacityLimit) {}
+    
+    bool tryPush(T& item) {
+        lock_guard<mutex> guard(lock);
+        if (items.size() >= capacity) return false;
+        items.push(std::move(item));
+        return true;
+    }
+    
+    optional<T> tryPop() {
+        lock_guard<mutex> guard(lock);
+        if (items.empty()) return nullopt;
+        optional<T> item(std::move(items.front()));
+        items.pop();
+        return item;
+    }
+    
+    bool empty() {
+        lock_guard<mutex> guard(lock);
+        return items.empty();
+    }
+};
+
 class BankServiceSystem {
 private:
-    queue<Customer> regularQueue;
-    queue<Customer> vipQueue;
-    queue<Customer> premiumQueue;
-    int nextToken;
+    ServiceScheduler<Customer> waiting; // every priority class, aging included; issues the tokens
     int totalCustomersServed;
     int totalWaitTime;
     vector<string> serviceLog;
     
+    static string classIcon(int priority) {
+        return priority == 1 ? "🌟" : priority == 2 ? "💎" : priority == 3 ? "👤" : "🎟️";
+    }
+    
+    static string className(int priority) {
+        return priority == 1 ? "VIP" : priority == 2 ? "Premium" : priority == 3 ? "Regular" : "Class " + to_string(priority);
+    }
+    
+    int totalWaiting() const { return (int)waiting.size(); }
+    
 public:
-    BankServiceSystem() : nextToken(1), totalCustomersServed(0), totalWaitTime(0) {
+    BankServiceSystem() : totalCustomersServed(0), totalWaitTime(0) {
         cout << "=== 🏦 Bank Customer Service System ===\n\n";
         cout << "🎫 Service System Initialized\n";
         cout << "📋 Available Services: Account Opening, Loan Application, \n";
         cout << "    Money Transfer, Balance Inquiry, Card Services\n\n";
     }
 
-    void addCustomer(const string& name, const string& service, int priority = 3) {
-        Customer newCustomer(name, nextToken++, service, priority);
-        
-        // Add to appropriate queue based on priority
-        switch(priority) {
-            case 1: // VIP
-                vipQueue.push(newCustomer);
-                cout << "🌟 VIP Customer " << name << " joined queue (Token #" 
-                     << newCustomer.token << " - " << service << ")\n";
-                break;
-            case 2: // Premium
-                premiumQueue.push(newCustomer);
-                cout << "💎 Premium Customer " << name << " joined queue (Token #" 
-                     << newCustomer.token << " - " << service << ")\n";
-                break;
-            default: // Regular
-                regularQueue.push(newCustomer);
-                cout << "👤 Regular Customer " << name << " joined queue (Token #" 
-                     << newCustomer.token << " - " << service << ")\n";
-                break;
+    // priority: 1=VIP, 2=Premium, 3=Regular, higher numbers are further classes
+    int addCustomer(const string& name, const string& service, int priority = 3) {
+        if (priority < 1 || priority > ServiceScheduler<Customer>::MAX_CLASSES) {
+            cout << "❌ Invalid priority " << priority << " for " << name << "\n";
+            return 0;
         }
+        int token = (int)waiting.nextToken();
+        waiting.push(Customer(name, token, service, priority), priority);
         
-        serviceLog.push_back("JOINED: " + name + " (Token #" + to_string(newCustomer.token) + ")");
+        cout << classIcon(priority) << " " << className(priority) << " Customer " << name
+             << " joined queue (Token #" << token << " - " << service << ")\n";
+        
+        serviceLog.push_back("JOINED: " + name + " (Token #" + to_string(token) + ")");
         displayQueueSizes();
+        return token;
     }
 
     void serveNextCustomer() {
-        Customer* customerToServe = nullptr;
-        string queueType;
-        
-        // Priority: VIP → Premium → Regular
-        if (!vipQueue.empty()) {
-            customerToServe = new Customer(vipQueue.front());
-            vipQueue.pop();
-            queueType = "VIP";
-        } else if (!premiumQueue.empty()) {
-            customerToServe = new Customer(premiumQueue.front());
-            premiumQueue.pop();
-            queueType = "Premium";
-        } else if (!regularQueue.empty()) {
-            customerToServe = new Customer(regularQueue.front());
-            regularQueue.pop();
-            queueType = "Regular";
-        } else {
+        if (waiting.empty()) {
             cout << "❌ No customers to serve! All queues are empty.\n";
             return;
         }
         
+        // Lowest (rank, token) first: VIP → Premium → Regular, with aging
+        Customer customer = waiting.pop();
+        string queueType = className(customer.priority);
+        
         totalCustomersServed++;
         
         // Simulate service time
-        int serviceTime = simulateServiceTime(customerToServe->serviceType);
+        int serviceTime = simulateServiceTime(customer.serviceType);
         
-        cout << "🔔 Now Serving: " << customerToServe->name 
-             << " (Token #" << customerToServe->token << ")\n";
-        cout << "   📝 Service: " << customerToServe->serviceType << "\n";
+        cout << "🔔 Now Serving: " << customer.name 
+             << " (Token #" << customer.token << ")\n";
+        cout << "   📝 Service: " << customer.serviceType << "\n";
         cout << "   ⭐ Queue Type: " << queueType << "\n";
         cout << "   ⏱️ Estimated Service Time: " << serviceTime << " minutes\n";
         
-        serviceLog.push_back("SERVED: " + customerToServe->name + " (" + 
-                           customerToServe->serviceType + ") - " + to_string(serviceTime) + "min");
+        serviceLog.push_back("SERVED: " + customer.name + " (" + 
+                           customer.serviceType + ") - " + to_string(serviceTime) + "min");
         
-        delete customerToServe;
         displayQueueSizes();
     }
+    
+    // Moves a waiting customer to another class (e.g. a Regular upgraded to VIP)
+    bool changePriority(int token, int priority) {
+        Customer* customer = waiting.find(token);
+        if (!customer || priority < 1 || priority > ServiceScheduler<Customer>::MAX_CLASSES) {
+            cout << "❌ Cannot move Token #" << token << " to priority " << priority << "\n";
+            return false;
+        }
+        string name = customer->name;
+        int previous = customer->priority;
+        customer->priority = priority;
+        waiting.changePriority(token, priority);
+        cout << "🔀 " << name << " (Token #" << token << ") moved from " << className(previous)
+             << " to " << className(priority) << "\n";
+        serviceLog.push_back("MOVED: " + name + " to " + className(priority));
+        displayQueueSizes();
+        return true;
+    }
+    
+    bool cancelCustomer(int token) {
+        optional<Customer> left = waiting.cancel(token);
+        if (!left) {
+            cout << "❌ Token #" << token << " is not waiting\n";
+            return false;
+        }
+        cout << "🚪 " << left->name << " (Token #" << token << ") left the queue\n";
+        serviceLog.push_back("LEFT: " + left->name + " (Token #" + to_string(token) + ")");
+        displayQueueSizes();
+        return true;
+    }
+    
+    // How many later VIP arrivals may overtake a customer per class step (0 = strict priority)
+    void setAging(int tokensPerClass) {
+        waiting.setAgingSpan(max(0, tokensPerClass));
+    }
 
     void displayAllQueues() {
         cout << "\n📊 Current Queue Status:\n";
@@ -127,87 +498,45 @@ public:
         cout << "║                         QUEUE OVERVIEW                       ║\n";
         cout << "╠══════════════════════════════════════════════════════════════╣\n";
         
-        // Display VIP Queue
-        cout << "║ 🌟 VIP Queue (" << vipQueue.size() << " customers)";
-        cout << string(41 - to_string(vipQueue.size()).length(), ' ') << "║\n";
-        
-        if (!vipQueue.empty()) {
-            queue<Customer> temp = vipQueue;
-            int position = 1;
-            while (!temp.empty() && position <= 3) {  // Show first 3
-                Customer c = temp.front();
-                temp.pop();
-                cout << "║   " << position << ". " << left << setw(15) << c.name 
-                     << "│ Token #" << setw(3) << c.token 
-                     << "│ " << left << setw(15) << c.serviceType << "║\n";
-                position++;
-            }
-            if (vipQueue.size() > 3) {
-                cout << "║   ... and " << (vipQueue.size() - 3) << " more";
-                cout << string(40, ' ') << "║\n";
-            }
-        } else {
-            cout << "║   (Empty)                                                    ║\n";
-        }
-        
-        cout << "╠══════════════════════════════════════════════════════════════╣\n";
-        
-        // Display Premium Queue
-        cout << "║ 💎 Premium Queue (" << premiumQueue.size() << " customers)";
-        cout << string(37 - to_string(premiumQueue.size()).length(), ' ') << "║\n";
+        // Each class in service order, first 3 shown
+        vector<vector<const Customer*>> byClass(max(3, waiting.lowestClass()) + 1);
+        waiting.forEachInOrder([&](const Customer& c, int priority, uint64_t) { byClass[priority].push_back(&c); });
         
-        if (!premiumQueue.empty()) {
-            queue<Customer> temp = premiumQueue;
-            int position = 1;
-            while (!temp.empty() && position <= 3) {
-                Customer c = temp.front();
-                temp.pop();
-                cout << "║   " << position << ". " << left << setw(15) << c.name 
-                     << "│ Token #" << setw(3) << c.token 
-                     << "│ " << left << setw(15) << c.serviceType << "║\n";
-                position++;
+        for (size_t priority = 1; priority < byClass.size(); priority++) {
+            const vector<const Customer*>& customers = byClass[priority];
+            if (priority > 3 && customers.empty()) continue;
+            if (priority > 1) cout << "╠══════════════════════════════════════════════════════════════╣\n";
+            
+            string label = " " + className(priority) + " Queue (";
+            cout << "║ " << classIcon(priority) << label << customers.size() << " customers)";
+            cout << string(max<int>(1, 53 - (int)label.size() - (int)to_string(customers.size()).length()), ' ') << "║\n";
+            
+            if (!customers.empty()) {
+                for (size_t position = 1; position <= min<size_t>(3, customers.size()); position++) {
+                    const Customer& c = *customers[position - 1];
+                    cout << "║   " << position << ". " << left << setw(15) << c.name 
+                         << "│ Token #" << setw(3) << c.token 
+                         << "│ " << left << setw(15) << c.serviceType << "║\n";
+                }
+                if (customers.size() > 3) {
+                    cout << "║   ... and " << (customers.size() - 3) << " more";
+                    cout << string(40, ' ') << "║\n";
+                }
+            } else {
+                cout << "║   (Empty)                                                    ║\n";
             }
-            if (premiumQueue.size() > 3) {
-                cout << "║   ... and " << (premiumQueue.size() - 3) << " more";
-                cout << string(40, ' ') << "║\n";
-            }
-        } else {
-            cout << "║   (Empty)                                                    ║\n";
-        }
-        
-        cout << "╠══════════════════════════════════════════════════════════════╣\n";
-        
-        // Display Regular Queue
-        cout << "║ 👤 Regular Queue (" << regularQueue.size() << " customers)";
-        cout << string(37 - to_string(regularQueue.size()).length(), ' ') << "║\n";
-        
-        if (!regularQueue.empty()) {
-            queue<Customer> temp = regularQueue;
-            int position = 1;
-            while (!temp.empty() && position <= 3) {
-                Customer c = temp.front();
-                temp.pop();
-                cout << "║   " << position << ". " << left << setw(15) << c.name 
-                     << "│ Token #" << setw(3) << c.token 
-                     << "│ " << left << setw(15) << c.serviceType << "║\n";
-                position++;
-            }
-            if (regularQueue.size() > 3) {
-                cout << "║   ... and " << (regularQueue.size() - 3) << " more";
-                cout << string(40, ' ') << "║\n";
-            }
-        } else {
-            cout << "║   (Empty)                                                    ║\n";
         }
         
         cout << "╚══════════════════════════════════════════════════════════════╝\n\n";
     }
 
     void displayQueueSizes() {
-        int totalCustomers = vipQueue.size() + premiumQueue.size() + regularQueue.size();
-        cout << "📈 Queue Sizes: VIP(" << vipQueue.size() << ") | Premium(" 
-             << premiumQueue.size() << ") | Regular(" << regularQueue.size() 
-             << ") | Total: " << totalCustomers << "\n";
+        cout << "📈 Queue Sizes: VIP(" << waiting.classSize(1) << ") | Premium(" 
+             << waiting.classSize(2) << ") | Regular(" << waiting.classSize(3) << ")";
+        for (int priority = 4; priority <= waiting.lowestClass(); priority++) {
+            if (waiting.classSize(priority)) cout << " | Class " << priority << "(" << waiting.classSize(priority) << ")";
+        }
+        cout << " | Total: " << totalWaiting() << "\n";
         cout << "────────────────────────────────────────────────────────\n";
     }
 
@@ -225,15 +554,15 @@ public:
     }
 
     void showStatistics() {
-        int totalInQueue = vipQueue.size() + premiumQueue.size() + regularQueue.size();
+        int totalInQueue = totalWaiting();
         
         cout << "\n📊 Bank Service Statistics:\n";
         cout << "├── Total Customers Served: " << totalCustomersServed << endl;
         cout << "├── Currently in Queue: " << totalInQueue << endl;
-        cout << "├── Next Token Number: " << nextToken << endl;
-        cout << "├── VIP Customers Waiting: " << vipQueue.size() << endl;
-        cout << "├── Premium Customers Waiting: " << premiumQueue.size() << endl;
-        cout << "├── Regular Customers Waiting: " << regularQueue.size() << endl;
+        cout << "├── Next Token Number: " << waiting.nextToken() << endl;
+        cout << "├── VIP Customers Waiting: " << waiting.classSize(1) << endl;
+        cout << "├── Premium Customers Waiting: " << waiting.classSize(2) << endl;
+        cout << "├── Regular Customers Waiting: " << waiting.classSize(3) << endl;
         cout << "└── Service Efficiency: " << fixed << setprecision(1) 
              << (totalCustomersServed > 0 ? (float)totalCustomersServed / (totalCustomersServed + totalInQueue) * 100 : 0) << "%" << endl;
     }
@@ -242,7 +571,7 @@ public:
         cout << "\n🎯 Queue Concepts Demonstrated:\n";
         cout << "• 🚶‍♂️ FIFO (First-In-First-Out) - fairness in service order\n";
         cout << "• 🏆 Priority Queues - VIP, Premium, Regular service levels\n";
-        cout << "• ⚡ O(1) Enqueue/Dequeue - constant time operations\n";
+        cout << "• ⚡ O(log n) Enqueue/Serve/Cancel - one indexed heap, tokens as handles\n";
         cout << "• 📊 Queue Management - multiple queue handling\n";
         cout << "• 🎫 Token System - systematic customer identification\n\n";
         
@@ -256,8 +585,9 @@ public:
         cout << "• Hospital Systems (emergency triage, appointment scheduling)\n";
     }
 
-private:
-    int simulateServiceTime(const string& serviceType) {
+    // Typical minutes per service type; BranchSimulator draws random service
+    // times around these means
+    static int simulateServiceTime(const string& serviceType) {
         // Simulate different service times based on service type
         if (serviceType == "Balance Inquiry") return 2;
         if (serviceType == "Money Transfer") return 5;
@@ -268,7 +598,613 @@ private:
     }
 };
 
-int main() {
+// 🧵 ConcurrentBankService: the branch with many kiosks and tellers at once
+//
+// Kiosk threads call addCustomer and teller threads call serveNextCustomer
+// concurrently. Each class has its own bounded queue (MpmcRing, or
+// LockedQueue for comparison) and tellers take VIP → Premium → Regular.
+// Tokens and counters are atomics and nothing is printed, so the queues are
+// the only shared state. Cancellation, priority changes and aging need one
+// global order and stay with the single-threaded BankServiceSystem.
+template <template <typename> class Line>
+class ConcurrentBankService {
+public:
+    static constexpr int CLASSES = 3;
+    
+private:
+    unique_ptr<Line<Customer>> lines[CLASSES];
+    atomic<int> nextToken{1};
+    atomic<long long> totalCustomersServed{0};
+    atomic<long long> totalServiceMinutes{0};
+    
+public:
+    explicit ConcurrentBankService(size_t capacityPerClass = 4096) {
+        for (auto& line : lines) line.reset(new Line<Customer>(capacityPerClass));
+    }
+    
+    // Returns the token, or 0 for an invalid priority; waits while that line is full
+    int addCustomer(const string& name, const string& service, int priority = 3) {
+        if (priority < 1 || priority > CLASSES) return 0;
+        int token = nextToken.fetch_add(1, memory_order_relaxed);
+        Customer customer(name, token, service, priority);
+        while (!lines[priority - 1]->tryPush(customer)) this_thread::yield();
+        return token;
+    }
+    
+    // Takes the most urgent waiting customer, or nothing if every line is empty
+    optional<Customer> serveNextCustomer() {
+        for (auto& line : lines) {
+            optional<Customer> customer = line->tryPop();
+            if (customer) {
+                totalCustomersServed.fetch_add(1, memory_order_relaxed);
+                totalServiceMinutes.fetch_add(BankServiceSystem::simulateServiceTime(customer->serviceType), memory_order_relaxed);
+                return customer;
+            }
+        }
+        return nullopt;
+    }
+    
+    long long customersServed() const { return totalCustomersServed.load(); }
+    long long serviceMinutes() const { return totalServiceMinutes.load(); }
+    int tokensIssued() const { return nextToken.load() - 1; }
+};
+
+// 📅 CalendarQueue: pending events bucketed by time like days in a calendar
+//
+// Bucket b holds events whose slot floor(time / width) is b modulo the
+// bucket count, each bucket sorted so its earliest event is at the back.
+// Popping walks forward one slot at a time from the current one, so with a
+// width near the typical gap between events push and pop are O(1) on
+// average. The bucket count doubles or halves with the number of pending
+// events, and the width is re-estimated from the earliest events then.
+template <typename Event>
+class CalendarQueue {
+    vector<vector<Event>> buckets;
+    double width = 1.0;
+    size_t count = 0;
+    uint64_t currentSlot = 0; // slot being scanned; never past the next event
+    double lastTime = 0;      // time of the last popped event
+    
+    uint64_t slotOf(double time) const { return (uint64_t)(time / width); }
+    
+    void insert(const Event& event) {
+        vector<Event>& bucket = buckets[slotOf(event.time) & (buckets.size() - 1)];
+        auto at = upper_bound(bucket.begin(), bucket.end(), event,
+                              [](const Event& a, const Event& b) { return a.time > b.time; });
+        bucket.insert(at, event);
+    }
+    
+    void resize(size_t bucketCount) {
+        vector<Event> all;
+        all.reserve(count);
+        for (auto& bucket : buckets) all.insert(all.end(), bucket.begin(), bucket.end());
+        sort(all.begin(), all.end(), [](const Event& a, const Event& b) { return a.time < b.time; });
+        // About three average gaps between the earliest events per bucket
+        size_t sample = min<size_t>(all.size(), 25);
+        if (sample > 1 && all[sample - 1].time > all[0].time) {
+            width = 3 * (all[sample - 1].time - all[0].time) / (sample - 1);
+        }
+        buckets.assign(bucketCount, {});
+        for (const Event& event : all) insert(event);
+        currentSlot = slotOf(lastTime);
+    }
+    
+public:
+    CalendarQueue() : buckets(2) {}
+    
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    
+    // Events must not be earlier than the last popped one
+    void push(const Event& event) {
+        insert(event);
+        if (++count > 2 * buckets.size()) resize(2 * buckets.size());
+    }
+    
+    Event pop() {
+        size_t mask = buckets.size() - 1;
+        for (size_t scanned = 0; scanned <= mask; scanned++, currentSlot++) {
+            vector<Event>& bucket = buckets[currentSlot & mask];
+            if (!bucket.empty() && slotOf(bucket.back().time) <= currentSlot) return take(bucket);
+        }
+        // Nothing within a whole year of buckets: jump straight to the earliest event
+        vector<Event>* earliest = nullptr;
+        for (auto& bucket : buckets) {
+            if (!bucket.empty() && (!earliest || bucket.back().time < earliest->back().time)) earliest = &bucket;
+        }
+        currentSlot = slotOf(earliest->back().time);
+        return take(*earliest);
+    }
+    
+private:
+    Event take(vector<Event>& bucket) {
+        Event event = bucket.back();
+        bucket.pop_back();
+        lastTime = event.time;
+        if (--count < buckets.size() / 2 && buckets.size() > 2) resize(buckets.size() / 2);
+        return event;
+    }
+};
+
+// 🎲 BranchSimulator: discrete-event model of a branch for capacity planning
+//
+// Customers arrive as a Poisson process, pick a class (10% VIP, 30% Premium,
+// 60% Regular) and a service, and wait in the same aging ServiceScheduler
+// BankServiceSystem uses until one of the tellers is free. Service times are
+// Erlang-2 around BankServiceSystem::simulateServiceTime. The event list is a
+// CalendarQueue holding the next arrival and one departure per busy teller.
+// Statistics start after the warm-up: waits per class in 0.1-minute bins,
+// time-weighted queue length and teller busy time.
+struct BranchConfig {
+    int tellers = 18;
+    double arrivalsPerHour = 120;
+    double hours = 100000;
+    double warmupHours = 10;
+    uint64_t seed = 1;
+};
+
+struct BranchReport {
+    BranchConfig config;
+    static constexpr int CLASSES = 3;
+    vector<uint64_t> waitBins[CLASSES];     // customers per 0.1 minute of waiting, by class
+    double waitMinutes[CLASSES] = {};
+    double longestWait[CLASSES] = {};
+    vector<double> minutesAtLength;         // time the line had exactly i customers (grown by doubling)
+    size_t longestLine = 0;                 // most customers waiting at once after warm-up
+    double busyTellerMinutes = 0, measuredMinutes = 0;
+    uint64_t events = 0, served = 0, servedAtOnce = 0;
+    double offeredLoad = 0;                 // mean busy tellers needed (arrival rate × mean service)
+    double seconds = 0;
+    
+    uint64_t servedIn(int cls) const {
+        uint64_t total = 0;
+        for (uint64_t n : waitBins[cls]) total += n;
+        return total;
+    }
+    
+    // Wait in minutes below which a fraction q of the class's (or, with -1, all) customers started
+    double waitPercentile(double q, int cls = -1) const {
+        size_t bins = 0;
+        uint64_t total = 0;
+        for (int c = 0; c < CLASSES; c++) {
+            if (cls < 0 || c == cls) {
+                bins = max(bins, waitBins[c].size());
+                total += servedIn(c);
+            }
+        }
+        uint64_t seen = 0;
+        for (size_t b = 0; b < bins; b++) {
+            for (int c = 0; c < CLASSES; c++) {
+                if ((cls < 0 || c == cls) && b < waitBins[c].size()) seen += waitBins[c][b];
+            }
+            if (total && seen >= q * total) return b * 0.1;
+        }
+        return 0;
+    }
+    
+    double meanWait(int cls = -1) const {
+        double minutes = 0;
+        uint64_t customers = 0;
+        for (int c = 0; c < CLASSES; c++) {
+            if (cls < 0 || c == cls) {
+                minutes += waitMinutes[c];
+                customers += servedIn(c);
+            }
+        }
+        return customers ? minutes / customers : 0;
+    }
+    
+    size_t lengthPercentile(double q) const {
+        double seen = 0;
+        for (size_t length = 0; length < minutesAtLength.size(); length++) {
+            seen += minutesAtLength[length];
+            if (seen >= q * measuredMinutes) return length;
+        }
+        return longestLine;
+    }
+    
+    double utilization() const { return measuredMinutes ? busyTellerMinutes / (config.tellers * measuredMinutes) : 0; }
+    bool stable() const { return offeredLoad < config.tellers; }
+};
+
+class BranchSimulator {
+    struct Event {
+        double time;
+        int teller; // -1 = next arrival
+    };
+    struct Waiting {
+        double arrival;
+        uint8_t service;
+        uint8_t cls;
+    };
+    struct Service {
+        string name;
+        double share;
+        double meanMinutes;
+    };
+    
+    BranchConfig config;
+    vector<Service> services;
+    uint64_t state;
+    
+    // xorshift64*: uniform in (0, 1]
+    double uniform() {
+        state ^= state >> 12; state ^= state << 25; state ^= state >> 27;
+        return ((state * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + (1.0 / 9007199254740992.0);
+    }
+    
+    double exponential(double mean) { return -mean * log(uniform()); }
+    
+public:
+    explicit BranchSimulator(const BranchConfig& branchConfig) : config(branchConfig), state(branchConfig.seed * 0x9E3779B97F4A7C15ULL | 1) {
+        const pair<const char*, double> mix[] = {
+            {"Balance Inquiry", 0.30}, {"Money Transfer", 0.30}, {"Card Services", 0.20},
+            {"Account Opening", 0.12}, {"Loan Application", 0.08}};
+        for (const auto& [name, share] : mix) services.push_back({name, share, (double)BankServiceSystem::simulateServiceTime(name)});
+    }
+    
+    BranchReport run() {
+        BranchReport report;
+        report.config = config;
+        const double arrivalGap = 60.0 / config.arrivalsPerHour;
+        const double warmup = config.warmupHours * 60, horizon = warmup + config.hours * 60;
+        for (const Service& service : services) report.offeredLoad += service.share * service.meanMinutes / arrivalGap;
+        
+        CalendarQueue<Event> events;
+        ServiceScheduler<Waiting> line;
+        vector<int> idleTellers;
+        for (int t = config.tellers - 1; t >= 0; t--) idleTellers.push_back(t);
+        double clock = 0, lastChange = 0;
+        
+        auto startService = [&](const Waiting& customer) {
+            int teller = idleTellers.back();
+            idleTellers.pop_back();
+            if (clock >= warmup) {
+                double wait = clock - customer.arrival;
+                size_t bin = (size_t)(wait * 10);
+                vector<uint64_t>& bins = report.waitBins[customer.cls];
+                if (bin >= bins.size()) bins.resize(max(bin + 1, bins.size() * 2));
+                bins[bin]++;
+                report.waitMinutes[customer.cls] += wait;
+                report.longestWait[customer.cls] = max(report.longestWait[customer.cls], wait);
+                report.served++;
+                report.servedAtOnce += wait == 0;
+            }
+            // Erlang-2: two exponential phases of half the mean each
+            double mean = services[customer.service].meanMinutes;
+            events.push({clock - mean * 0.5 * log(uniform() * uniform()), teller});
+        };
+        
+        auto start = steady_clock::now();
+        events.push({exponential(arrivalGap), -1});
+        while (!events.empty()) {
+            Event event = events.pop();
+            if (event.time > horizon) break;
+            clock = event.time;
+            report.events++;
+            
+            // Time-weighted state since the previous event, counted after warm-up
+            if (clock > warmup) {
+                double dt = clock - max(lastChange, warmup);
+                size_t length = line.size();
+                if (length >= report.minutesAtLength.size()) report.minutesAtLength.resize(max(length + 1, report.minutesAtLength.size() * 2));
+                report.minutesAtLength[length] += dt;
+                report.longestLine = max(report.longestLine, length);
+                report.busyTellerMinutes += dt * (config.tellers - idleTellers.size());
+                report.measuredMinutes += dt;
+            }
+            lastChange = clock;
+            
+            if (event.teller < 0) {
+                events.push({clock + exponential(arrivalGap), -1});
+                double pick = uniform();
+                uint8_t cls = pick < 0.10 ? 0 : pick < 0.40 ? 1 : 2;
+                double r = uniform();
+                uint8_t service = 0;
+                while ((size_t)service + 1 < services.size() && r > services[service].share) r -= services[service++].share;
+                Waiting customer{clock, service, cls};
+                if (!idleTellers.empty()) startService(customer);
+                else line.push(customer, cls + 1);
+            } else {
+                idleTellers.push_back(event.teller);
+                if (!line.empty()) startService(line.pop());
+            }
+        }
+        report.seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+        return report;
+    }
+};
+
+// Scheduler throughput at `customers` waiting against the previous three
+// std::queue design (serve copied the front into a new Customer)
+void runSchedulerBenchmark(size_t customers) {
+    cout << "=== 🎯 Scheduler Benchmark (" << customers << " customers waiting) ===\n\n";
+    cout << fixed << setprecision(2);
+    const string services[] = {"Balance Inquiry", "Money Transfer", "Account Opening", "Loan Application", "Card Services"};
+    auto priorityFor = [](uint32_t r) { return r % 10 == 0 ? 1 : r % 10 < 4 ? 2 : 3; };
+    auto seconds = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        fn();
+        return duration_cast<duration<double>>(high_resolution_clock::now() - t0).count();
+    };
+    auto rate = [](size_t ops, double s) { return ops / s / 1e6; };
+    const size_t steadyOps = min<size_t>(customers, 1000000);
+    
+    cout << "🏦 Indexed 4-ary heap (one scheduler, aging every 32 tokens):\n";
+    {
+        mt19937 rng(1);
+        ServiceScheduler<Customer> scheduler;
+        scheduler.reserve(customers);
+        size_t checksum = 0;
+        double fill = seconds([&] {
+            for (size_t i = 0; i < customers; i++) {
+                int priority = priorityFor(rng());
+                scheduler.push(Customer("C" + to_string(i), (int)scheduler.nextToken(), services[i % 5], priority), priority);
+            }
+        });
+        double steady = seconds([&] {
+            for (size_t i = 0; i < steadyOps; i++) {
+                checksum += scheduler.pop().token;
+                int priority = priorityFor(rng());
+                scheduler.push(Customer("N" + to_string(i), (int)scheduler.nextToken(), services[i % 5], priority), priority);
+            }
+        });
+        size_t changed = 0, cancelled = 0;
+        double adjust = seconds([&] {
+            for (size_t i = 0; i < steadyOps; i++) {
+                uint64_t token = scheduler.nextToken() - 1 - rng() % customers;
+                if (i % 2 ? scheduler.changePriority(token, priorityFor(rng())) : scheduler.cancel(token).has_value()) {
+                    (i % 2 ? changed : cancelled)++;
+                }
+            }
+        });
+        size_t memory = scheduler.memoryBytes(), remaining = scheduler.size();
+        double drain = seconds([&] { while (!scheduler.empty()) checksum += scheduler.pop().token; });
+        cout << "├── Enqueue " << customers << ": " << rate(customers, fill) << " M/s\n";
+        cout << "├── Serve + enqueue at full size (" << steadyOps << "): " << rate(steadyOps, steady) << " M pairs/s\n";
+        cout << "├── " << changed << " priority changes + " << cancelled << " cancellations by token: "
+             << rate(steadyOps, adjust) << " M/s\n";
+        cout << "├── Drain " << remaining << ": " << rate(remaining, drain) << " M/s\n";
+        cout << "└── Memory: " << memory / 1048576.0 << " MB (" << (double)memory / customers << " bytes per customer)"
+             << (checksum ? "" : " ") << "\n\n";
+    }
+    
+    cout << "🐢 Three std::queue<Customer> (previous design):\n";
+    {
+        mt19937 rng(1);
+        queue<Customer> vipQueue, premiumQueue, regularQueue;
+        auto enqueue = [&](Customer customer) {
+            int priority = customer.priority;
+            (priority == 1 ? vipQueue : priority == 2 ? premiumQueue : regularQueue).push(std::move(customer));
+        };
+        auto serve = [&] {
+            queue<Customer>& from = !vipQueue.empty() ? vipQueue : !premiumQueue.empty() ? premiumQueue : regularQueue;
+            Customer* served = new Customer(from.front());
+            from.pop();
+            int token = served->token;
+            delete served;
+            return token;
+        };
+        size_t checksum = 0;
+        int token = 1;
+        double fill = seconds([&] {
+            for (size_t i = 0; i < customers; i++) enqueue(Customer("C" + to_string(i), token++, services[i % 5], priorityFor(rng())));
+        });
+        double steady = seconds([&] {
+            for (size_t i = 0; i < steadyOps; i++) {
+                checksum += serve();
+                enqueue(Customer("N" + to_string(i), token++, services[i % 5], priorityFor(rng())));
+            }
+        });
+        // Cancelling by token means rebuilding a queue without it
+        const int scans = 3;
+        double cancel = seconds([&] {
+            for (int i = 0; i < scans; i++) {
+                int target = token - 1 - (int)(rng() % customers);
+                queue<Customer> kept;
+                while (!regularQueue.empty()) {
+                    if (regularQueue.front().token != target) kept.push(std::move(regularQueue.front()));
+                    regularQueue.pop();
+                }
+                regularQueue.swap(kept);
+            }
+        });
+        size_t remaining = vipQueue.size() + premiumQueue.size() + regularQueue.size();
+        double drain = seconds([&] { while (!vipQueue.empty() || !premiumQueue.empty() || !regularQueue.empty()) checksum += serve(); });
+        cout << "├── Enqueue " << customers << ": " << rate(customers, fill) << " M/s\n";
+        cout << "├── Serve + enqueue at full size (" << steadyOps << "): " << rate(steadyOps, steady) << " M pairs/s (no aging: Regular starves)\n";
+        cout << "├── Cancel by token: " << cancel / scans * 1000 << " ms each (linear rebuild), no priority change\n";
+        cout << "└── Drain " << remaining << ": " << rate(remaining, drain) << " M/s" << (checksum ? "" : " ") << "\n";
+    }
+}
+
+// One run of the threaded branch: `kiosks` threads add `customers` in total
+// while `tellers` threads serve them; every call is timed
+template <template <typename> class Line>
+void simulateBranch(const string& title, int kiosks, int tellers, size_t customers) {
+    const string services[] = {"Balance Inquiry", "Money Transfer", "Account Opening", "Loan Application", "Card Services"};
+    ConcurrentBankService<Line> bank;
+    vector<vector<uint32_t>> addNanos(kiosks), serveNanos(tellers);
+    vector<unsigned long long> tokenSums(tellers, 0);
+    atomic<bool> go{false};
+    auto nanosSince = [](steady_clock::time_point t0) {
+        return (uint32_t)min<long long>(UINT32_MAX, duration_cast<nanoseconds>(steady_clock::now() - t0).count());
+    };
+    
+    vector<thread> threads;
+    for (int k = 0; k < kiosks; k++) {
+        size_t share = customers / kiosks + ((size_t)k < customers % kiosks);
+        addNanos[k].reserve(share);
+        threads.emplace_back([&, k, share] {
+            uint32_t seed = 2463534242u + k;
+            string name = "Kiosk" + to_string(k) + " guest";
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            for (size_t i = 0; i < share; i++) {
+                seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+                int priority = seed % 10 == 0 ? 1 : seed % 10 < 4 ? 2 : 3;
+                auto t0 = steady_clock::now();
+                bank.addCustomer(name, services[i % 5], priority);
+                addNanos[k].push_back(nanosSince(t0));
+            }
+        });
+    }
+    for (int t = 0; t < tellers; t++) {
+        serveNanos[t].reserve(customers / tellers * 2);
+        threads.emplace_back([&, t] {
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            while (bank.customersServed() < (long long)customers) {
+                auto t0 = steady_clock::now();
+                optional<Customer> customer = bank.serveNextCustomer();
+                if (!customer) {
+                    this_thread::yield();
+                    continue;
+                }
+                serveNanos[t].push_back(nanosSince(t0));
+                tokenSums[t] += customer->token;
+            }
+        });
+    }
+    
+    auto start = steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread& th : threads) th.join();
+    double seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    
+    auto report = [](vector<vector<uint32_t>>& perThread) {
+        vector<uint32_t> all;
+        for (auto& samples : perThread) all.insert(all.end(), samples.begin(), samples.end());
+        if (all.empty()) return string("-");
+        auto at = [&](double q) {
+            auto nth = all.begin() + min(all.size() - 1, (size_t)(q * all.size()));
+            nth_element(all.begin(), nth, all.end());
+            return to_string(*nth);
+        };
+        return at(0.5) + " / " + at(0.99) + " / " + at(0.999) + " / " + to_string(*max_element(all.begin(), all.end()));
+    };
+    unsigned long long tokenSum = 0;
+    for (unsigned long long sum : tokenSums) tokenSum += sum;
+    bool exact = bank.customersServed() == (long long)customers && bank.tokensIssued() == (int)customers
+              && tokenSum == (unsigned long long)customers * (customers + 1) / 2;
+    
+    cout << title << "\n";
+    cout << "├── " << kiosks << " kiosks × " << tellers << " tellers, " << customers << " customers: "
+         << seconds * 1000 << " ms\n";
+    cout << "├── Throughput: " << customers / seconds / 1e6 << " M customers/s ("
+         << 2 * customers / seconds / 1e6 << " M queue ops/s)\n";
+    cout << "├── addCustomer ns (p50 / p99 / p99.9 / max): " << report(addNanos) << "\n";
+    cout << "├── serveNextCustomer ns (p50 / p99 / p99.9 / max): " << report(serveNanos) << "\n";
+    cout << "└── Every token served exactly once: " << (exact ? "✅" : "❌") << "\n\n";
+}
+
+void runConcurrentSimulation(int kiosks, int tellers, size_t customers) {
+    cout << "=== 🧵 Threaded Branch Simulation ===\n\n";
+    cout << fixed << setprecision(2);
+    unsigned cores = thread::hardware_concurrency();
+    cout << "💻 Hardware threads: " << cores;
+    if (cores && cores < (unsigned)(kiosks + tellers)) cout << " (fewer than " << kiosks + tellers << " threads: they time-slice)";
+    cout << "\n\n";
+    simulateBranch<MpmcRing>("🔄 Lock-free MpmcRing per class (4096 slots):", kiosks, tellers, customers);
+    simulateBranch<LockedQueue>("🔒 Mutex + std::queue per class (4096 slots):", kiosks, tellers, customers);
+}
+
+void runBranchSimulation(const BranchConfig& config) {
+    cout << "=== 🎲 Branch Simulation: " << config.tellers << " tellers, " << config.arrivalsPerHour
+         << " arrivals/hour, " << config.hours << " hours ===\n\n";
+    BranchReport report = BranchSimulator(config).run();
+    cout << fixed << setprecision(2);
+    const char* names[] = {"🌟 VIP", "💎 Premium", "👤 Regular"};
+    
+    cout << "⏳ Wait before service (minutes):\n";
+    cout << "   Class        Served        Mean     p50     p90     p99   p99.9     Max\n";
+    for (int cls = -1; cls < BranchReport::CLASSES; cls++) {
+        double longest = cls < 0 ? max({report.longestWait[0], report.longestWait[1], report.longestWait[2]}) : report.longestWait[cls];
+        cout << "   " << left << setw(cls < 0 ? 11 : 12) << (cls < 0 ? "📊 All" : names[cls]) << right
+             << setw(12) << (cls < 0 ? report.served : report.servedIn(cls))
+             << setw(12) << report.meanWait(cls) << setw(8) << report.waitPercentile(0.5, cls)
+             << setw(8) << report.waitPercentile(0.9, cls) << setw(8) << report.waitPercentile(0.99, cls)
+             << setw(8) << report.waitPercentile(0.999, cls) << setw(8) << longest << "\n";
+    }
+    cout << "   Served without waiting: " << (report.served ? 100.0 * report.servedAtOnce / report.served : 0) << "%\n";
+    
+    cout << "\n📏 Line length (time-weighted): p50 " << report.lengthPercentile(0.5) << " | p90 "
+         << report.lengthPercentile(0.9) << " | p99 " << report.lengthPercentile(0.99) << " | max "
+         << report.longestLine << "\n";
+    cout << "👩‍💼 Teller utilization: " << 100 * report.utilization() << "% (offered load "
+         << report.offeredLoad << " tellers)" << (report.stable() ? "" : " ⚠️ understaffed: the line grows without bound") << "\n";
+    cout << "⚡ " << report.events << " events in " << report.seconds << " s: " << report.events / report.seconds / 1e6
+         << " M events/s (" << report.events / report.seconds * 60 / 1e8 << " × 10^8 per minute)\n";
+}
+
+// Runs one simulation per staffing level, spread over the hardware threads
+void runStaffingSweep(int fewestTellers, int mostTellers, BranchConfig config) {
+    unsigned workers = max(1u, thread::hardware_concurrency());
+    int levels = mostTellers - fewestTellers + 1;
+    cout << "=== 👥 Staffing Sweep: " << fewestTellers << "-" << mostTellers << " tellers, " << config.arrivalsPerHour
+         << " arrivals/hour, " << config.hours << " hours each, " << min<unsigned>(workers, levels) << " worker thread(s) ===\n\n";
+    
+    vector<BranchReport> reports(levels);
+    atomic<int> next{0};
+    auto start = steady_clock::now();
+    vector<thread> pool;
+    for (unsigned w = 0; w < min<unsigned>(workers, levels); w++) {
+        pool.emplace_back([&] {
+            for (int i; (i = next.fetch_add(1)) < levels;) {
+                BranchConfig level = config;
+                level.tellers = fewestTellers + i;
+                reports[i] = BranchSimulator(level).run();
+            }
+        });
+    }
+    for (thread& worker : pool) worker.join();
+    double seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    
+    cout << fixed << setprecision(2);
+    cout << "Tellers  Util%   Mean wait   p90 wait   p99 wait   VIP p99   Line p50   Line p99\n";
+    uint64_t events = 0;
+    for (const BranchReport& report : reports) {
+        events += report.events;
+        cout << setw(7) << report.config.tellers << setw(7) << 100 * report.utilization()
+             << setw(12) << report.meanWait() << setw(11) << report.waitPercentile(0.9)
+             << setw(11) << report.waitPercentile(0.99) << setw(10) << report.waitPercentile(0.99, 0)
+             << setw(11) << report.lengthPercentile(0.5) << setw(11) << report.lengthPercentile(0.99)
+             << (report.stable() ? "" : "  ⚠️ understaffed") << "\n";
+    }
+    cout << "\n⚡ " << events << " events in " << seconds << " s: " << events / seconds * 60 / 1e8
+         << " × 10^8 events per minute across the sweep\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        long long customers = argc > 2 ? atoll(argv[2]) : 10000000;
+        runSchedulerBenchmark(customers > 0 ? customers : 10000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--threads") {
+        int kiosks = argc > 2 ? atoi(argv[2]) : 4;
+        int tellers = argc > 3 ? atoi(argv[3]) : 4;
+        long long customers = argc > 4 ? atoll(argv[4]) : 2000000;
+        runConcurrentSimulation(max(1, kiosks), max(1, tellers), customers > 0 ? customers : 2000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--simulate") {
+        BranchConfig config;
+        if (argc > 2) config.tellers = max(1, atoi(argv[2]));
+        if (argc > 3 && atof(argv[3]) > 0) config.arrivalsPerHour = atof(argv[3]);
+        if (argc > 4 && atof(argv[4]) > 0) config.hours = atof(argv[4]);
+        runBranchSimulation(config);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--sweep") {
+        BranchConfig config;
+        config.hours = 20000;
+        int fewest = argc > 2 ? max(1, atoi(argv[2])) : 14;
+        int most = argc > 3 ? max(fewest, atoi(argv[3])) : max(fewest, 22);
+        if (argc > 4 && atof(argv[4]) > 0) config.arrivalsPerHour = atof(argv[4]);
+        if (argc > 5 && atof(argv[5]) > 0) config.hours = atof(argv[5]);
+        runStaffingSweep(fewest, most, config);
+        return 0;
+    }
+    
     BankServiceSystem bank;
     
     cout << "🏦 Starting Bank Service Simulation:\n\n";
@@ -307,8 +1243,12 @@ int main() {
     // Add some more customers while serving
     cout << "🚶‍♂️ More customers arriving:\n";
     bank.addCustomer("Jack Ryan", "Balance Inquiry", 1);      // VIP
-    bank.addCustomer("Kate Bishop", "Loan Application");      // Regular
-    bank.addCustomer("Leo Stark", "Card Services", 2);       // Premium
+    int kate = bank.addCustomer("Kate Bishop", "Loan Application");      // Regular
+    int leo = bank.addCustomer("Leo Stark", "Card Services", 2);       // Premium
+    
+    cout << "\n🔀 Kate Bishop is upgraded and Leo Stark leaves:\n";
+    bank.changePriority(kate, 2);
+    bank.cancelCustomer(leo);
     
     cout << "\n🔔 Continuing service:\n";
     
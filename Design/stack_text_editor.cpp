@@ -6,10 +6,34 @@
  * stacks store previous and next states of your document. This demonstrates
  * the LIFO (Last-In-First-Out) principle in action.
  * 
+ * Each stack entry is a delta (command pattern): an insert or delete at an
+ * offset together with the affected text. Undo applies the inverse command
+ * and redo re-applies it, so neither copies the document. Optional
+ * checkpoints (a full copy every N operations) let long undo jumps restore a
+ * copy instead of replaying every delta.
+ * 
  * Time Complexity:
  * - Push/Pop: O(1)
- * - Undo/Redo: O(1)
- * Space Complexity: O(n) where n is number of operations
+ * - Undo/Redo: O(edit size) (plus moving the text after the offset)
+ * Space Complexity: O(total edited text), not O(document size × history)
+ * 
+ * The document itself is a PieceTable (pieces of an original and an add
+ * buffer in a persistent treap), so edits anywhere cost O(log pieces) and
+ * checkpoints are O(1) snapshots.
+ * 
+ * Run with --bench [mb] [edits] for memory and per-operation latency on a
+ * large document, or --pieces [mb] [edits] to compare random-position edits
+ * against a single std::string. Word and line counts are kept up to date from
+ * each delta; --keystrokes [mb] [n] times typing with a live word count.
+ * 
+ * History can be held to a byte budget (typing coalesced into word-sized
+ * units, old units compacted into checkpoints or spilled to a compressed
+ * log); --history [budget KB] [keystrokes] compares the two.
+ * 
+ * openJournal() adds a write-ahead journal with snapshots so the document
+ * survives a restart or crash; --journal [mb] [keystrokes] measures typing
+ * latency with it attached and recovery time against journal length.
+ * Build with -pthread (the journal writer is a background thread).
  */
 
 #include <iostream>
@@ -18,126 +42,1508 @@
 #include <chrono>
 #include <iomanip>
 #include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string_view>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <filesystem>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 using namespace std;
 using namespace std::chrono;
 
+// 🧩 PieceTable: the document as pieces of two buffers, kept in a treap
+//
+// The original text is never modified and typed text is only ever appended
+// to an add buffer; the document is the in-order sequence of pieces
+// (buffer, start, length) in an implicit treap keyed by position, where each
+// node stores the total length of its subtree. Insert and erase split the
+// treap at a position (cutting at most one piece in two) and merge it back,
+// so both are O(log n) in the number of pieces regardless of document size.
+// Typing at the end of the newest piece just extends it.
+// Nodes are reference counted and shared between versions: snapshot() is
+// O(1), and an edit copies only the nodes on its path that a snapshot still
+// shares (path copying). A Version must not outlive its PieceTable, whose
+// buffers it reads.
+// The add buffer is a list of fixed-capacity blocks that never move, so
+// spans() can hand another thread (pointer, length) views of the current
+// text while typing goes on appending behind them.
+class PieceTable {
+    struct Node {
+        size_t start;
+        size_t length;
+        size_t total; // characters in this subtree
+        uint32_t priority;
+        int refs;
+        uint32_t nodes;  // nodes in this subtree
+        uint32_t buffer; // 0 = the original, i = add block i - 1
+        Node* left;
+        Node* right;
+    };
+    
+    struct Block {
+        unique_ptr<char[]> bytes;
+        size_t used, capacity;
+    };
+    static constexpr size_t firstBlockBytes = 4 << 10, maxBlockBytes = 1 << 20;
+    
+    shared_ptr<const string> original = make_shared<const string>();
+    vector<shared_ptr<Block>> blocks; // the add buffer
+    size_t blockBytes = 0;
+    Node* root = nullptr;
+    uint32_t seed = 2463534242u;
+    size_t nodeCount = 0; // live nodes across all versions
+    
+    uint32_t nextPriority() {
+        seed ^= seed << 13; // xorshift32
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+    
+    static size_t total(const Node* n) { return n ? n->total : 0; }
+    static size_t nodes(const Node* n) { return n ? n->nodes : 0; }
+    static void update(Node* n) {
+        n->total = total(n->left) + n->length + total(n->right);
+        n->nodes = 1 + nodes(n->left) + nodes(n->right);
+    }
+    
+    static Node* retain(Node* n) {
+        if (n) n->refs++;
+        return n;
+    }
+    
+    // Drops one reference; frees the node and whatever only it kept alive
+    void release(Node* n) {
+        vector<Node*> pending{n};
+        while (!pending.empty()) {
+            Node* at = pending.back();
+            pending.pop_back();
+            if (!at || --at->refs > 0) continue;
+            pending.push_back(at->left);
+            pending.push_back(at->right);
+            delete at;
+            nodeCount--;
+        }
+    }
+    
+    Node* makeNode(uint32_t buffer, size_t start, size_t length) {
+        nodeCount++;
+        return new Node{start, length, length, nextPriority(), 1, 1, buffer, nullptr, nullptr};
+    }
+    
+    const char* bufferData(uint32_t buffer) const {
+        return buffer ? blocks[buffer - 1]->bytes.get() : original->data();
+    }
+    
+    // Starts a new add block when the current one cannot take `bytes` more;
+    // block sizes double up to maxBlockBytes (or the text size, if larger)
+    void reserveAdd(size_t bytes) {
+        if (!blocks.empty() && blocks.back()->capacity - blocks.back()->used >= bytes) return;
+        size_t capacity = blocks.empty() ? firstBlockBytes : min(blocks.back()->capacity * 2, maxBlockBytes);
+        capacity = max(capacity, bytes);
+        blocks.push_back(make_shared<Block>(Block{unique_ptr<char[]>(new char[capacity]), 0, capacity}));
+        blockBytes += capacity;
+    }
+    
+    // Takes an owned reference; returns a node only this version can see
+    Node* makeUnique(Node* n) {
+        if (n->refs == 1) return n;
+        Node* copy = new Node(*n);
+        nodeCount++;
+        copy->refs = 1;
+        retain(copy->left);
+        retain(copy->right);
+        release(n);
+        return copy;
+    }
+    
+    // Splits an owned treap into [0, pos) and [pos, end)
+    pair<Node*, Node*> split(Node* t, size_t pos) {
+        if (!t) return {nullptr, nullptr};
+        t = makeUnique(t);
+        size_t leftLength = total(t->left);
+        if (pos <= leftLength) {
+            auto [a, b] = split(t->left, pos);
+            t->left = b;
+            update(t);
+            return {a, t};
+        }
+        if (pos >= leftLength + t->length) {
+            auto [a, b] = split(t->right, pos - leftLength - t->length);
+            t->right = a;
+            update(t);
+            return {t, b};
+        }
+        // pos falls inside this piece: cut it in two
+        size_t cut = pos - leftLength;
+        Node* tail = makeNode(t->buffer, t->start + cut, t->length - cut);
+        Node* after = t->right;
+        t->length = cut;
+        t->right = nullptr;
+        update(t);
+        return {t, merge(tail, after)};
+    }
+    
+    Node* merge(Node* a, Node* b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->priority > b->priority) {
+            a = makeUnique(a);
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b = makeUnique(b);
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+    
+    // Grows the last piece of t by extra characters if it ends where the add
+    // buffer ends (consecutive typing); returns false if it does not
+    bool extendLast(Node*& t, size_t extra) {
+        Node* last = t;
+        while (last && last->right) last = last->right;
+        if (!last || last->buffer != blocks.size() || last->start + last->length != blocks.back()->used) return false;
+        vector<Node**> spine;
+        for (Node** at = &t; *at; at = &(*at)->right) {
+            *at = makeUnique(*at);
+            spine.push_back(at);
+        }
+        (*spine.back())->length += extra;
+        for (size_t i = spine.size(); i-- > 0;) update(*spine[i]);
+        return true;
+    }
+    
+    // Calls fn(string_view) for the slices covering [from, from + count)
+    template <typename Visitor>
+    void visitRange(const Node* n, size_t nodeStart, size_t from, size_t to, Visitor& fn) const {
+        if (!n || from >= to || to <= nodeStart || nodeStart + n->total <= from) return;
+        visitRange(n->left, nodeStart, from, to, fn);
+        size_t pieceStart = nodeStart + total(n->left);
+        size_t lo = max(from, pieceStart), hi = min(to, pieceStart + n->length);
+        if (lo < hi) fn(string_view(bufferData(n->buffer) + n->start + (lo - pieceStart), hi - lo));
+        visitRange(n->right, pieceStart + n->length, from, to, fn);
+    }
+    
+public:
+    // A saved state of the document; copying one is O(1)
+    class Version {
+        friend class PieceTable;
+        PieceTable* owner = nullptr;
+        Node* root = nullptr;
+        
+        Version(PieceTable* table, Node* sharedRoot) : owner(table), root(sharedRoot) {}
+        
+    public:
+        Version() = default;
+        Version(const Version& other) : owner(other.owner), root(retain(other.root)) {}
+        Version(Version&& other) noexcept : owner(other.owner), root(other.root) { other.root = nullptr; }
+        Version& operator=(Version other) {
+            swap(owner, other.owner);
+            swap(root, other.root);
+            return *this;
+        }
+        ~Version() { if (root) owner->release(root); }
+        
+        size_t size() const { return total(root); }
+    };
+    
+    PieceTable() = default;
+    PieceTable(const PieceTable&) = delete;
+    PieceTable& operator=(const PieceTable&) = delete;
+    ~PieceTable() { if (root) release(root); }
+    
+    // Replaces the document; the text becomes the read-only original buffer
+    void load(string text) {
+        if (root) release(root);
+        root = nullptr;
+        original = make_shared<const string>(std::move(text));
+        blocks.clear();
+        blockBytes = 0;
+        if (!original->empty()) root = makeNode(0, 0, original->size());
+    }
+    
+    void insert(size_t pos, string_view text) {
+        if (text.empty()) return;
+        reserveAdd(text.size());
+        Block& block = *blocks.back();
+        auto [left, right] = split(root, pos);
+        if (!extendLast(left, text.size())) left = merge(left, makeNode((uint32_t)blocks.size(), block.used, text.size()));
+        memcpy(block.bytes.get() + block.used, text.data(), text.size());
+        block.used += text.size();
+        root = merge(left, right);
+    }
+    
+    void erase(size_t pos, size_t count) {
+        auto [left, rest] = split(root, pos);
+        auto [removed, right] = split(rest, count);
+        if (removed) release(removed);
+        root = merge(left, right);
+    }
+    
+    Version snapshot() { return Version(this, retain(root)); }
+    
+    void restore(const Version& version) {
+        Node* previous = root;
+        root = retain(version.root);
+        if (previous) release(previous);
+    }
+    
+    size_t size() const { return total(root); }
+    bool empty() const { return size() == 0; }
+    size_t pieceCount() const { return nodeCount; }
+    
+    // Character at pos (pos < size()), O(log pieces)
+    char at(size_t pos) const {
+        const Node* n = root;
+        while (true) {
+            size_t leftLength = total(n->left);
+            if (pos < leftLength) {
+                n = n->left;
+            } else if (pos < leftLength + n->length) {
+                return bufferData(n->buffer)[n->start + pos - leftLength];
+            } else {
+                pos -= leftLength + n->length;
+                n = n->right;
+            }
+        }
+    }
+    
+    template <typename Visitor>
+    void forEachSlice(size_t from, size_t count, Visitor fn) const {
+        visitRange(root, 0, from, from + min(count, size() - min(from, size())), fn);
+    }
+    
+    template <typename Visitor>
+    void forEachSlice(Visitor fn) const { forEachSlice(0, size(), fn); }
+    
+    string substr(size_t from, size_t count) const {
+        string out;
+        out.reserve(min(count, size()));
+        forEachSlice(from, count, [&](string_view slice) { out.append(slice); });
+        return out;
+    }
+    
+    string str() const { return substr(0, size()); }
+    
+    // Streams the document piece by piece, without building the full string
+    void writeTo(ostream& out) const {
+        forEachSlice([&](string_view slice) { out.write(slice.data(), slice.size()); });
+    }
+    
+    // The current text as views into buffers that are never modified, and
+    // the references that keep those buffers alive. O(pieces) to build; the
+    // views stay valid on any thread while this table keeps being edited.
+    struct Spans {
+        vector<string_view> slices;
+        vector<shared_ptr<const void>> keepAlive;
+        size_t bytes = 0;
+    };
+    
+    Spans spans() const {
+        Spans out;
+        out.slices.reserve(nodes(root));
+        forEachSlice([&](string_view slice) { out.slices.push_back(slice); });
+        out.bytes = size();
+        out.keepAlive.push_back(original);
+        for (const auto& block : blocks) out.keepAlive.push_back(block);
+        return out;
+    }
+    
+    size_t memoryBytes() const {
+        return original->capacity() + blockBytes + nodeCount * sizeof(Node);
+    }
+    
+    // Bytes of nodes that only saved versions keep alive
+    size_t retainedBytes() const { return (nodeCount - nodes(root)) * sizeof(Node); }
+};
+
+// Word and line counts of a text; a word is a maximal run of characters
+// other than ' ', '\t' and '\n'
+struct TextStats {
+    size_t words = 0;
+    size_t newlines = 0;
+    
+    bool operator==(const TextStats& other) const { return words == other.words && newlines == other.newlines; }
+};
+
+inline bool isWordSpace(char c) { return c == ' ' || c == '\t' || c == '\n'; }
+
+// Full count over one slice. afterSpace carries "previous character was a
+// space (or there was none)" across slices. The SSE2 path classifies 16
+// bytes per step: a word starts wherever a non-space byte follows a space.
+void countSlice(string_view text, bool& afterSpace, TextStats& stats) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= text.size(); i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+        __m128i isNewline = _mm_cmpeq_epi8(bytes, newline);
+        __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)), isNewline);
+        unsigned spaces = (unsigned)_mm_movemask_epi8(isSpace);
+        unsigned previousSpaces = ((spaces << 1) | (afterSpace ? 1u : 0u)) & 0xFFFFu;
+        stats.words += __builtin_popcount(~spaces & previousSpaces & 0xFFFFu);
+        stats.newlines += __builtin_popcount((unsigned)_mm_movemask_epi8(isNewline));
+        afterSpace = (spaces >> 15) & 1;
+    }
+#endif
+    for (; i < text.size(); i++) {
+        bool spaceHere = isWordSpace(text[i]);
+        stats.words += afterSpace && !spaceHere;
+        stats.newlines += text[i] == '\n';
+        afterSpace = spaceHere;
+    }
+}
+
+TextStats countText(string_view text) {
+    TextStats stats;
+    bool afterSpace = true;
+    countSlice(text, afterSpace, stats);
+    return stats;
+}
+
+void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += (char)(value | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+uint64_t getVarint(string_view in, size_t& at) {
+    uint64_t value = 0;
+    for (int shift = 0; at < in.size() && shift < 64; shift += 7) {
+        uint8_t byte = in[at++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw runtime_error("truncated varint");
+}
+
+// CRC-32 of data; pass the CRC of the preceding bytes to continue over
+// several pieces: crc32(b, crc32(a)) == crc32(a + b)
+uint32_t crc32(string_view data, uint32_t previous = 0) {
+    static const auto table = [] {
+        array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+        return entries;
+    }();
+    uint32_t crc = ~previous;
+    for (unsigned char byte : data) crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Pushes a stdio file's buffer to the OS and the OS's copy to the disk
+bool syncToDisk(FILE* file) {
+    if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// 📓 EditJournal: write-ahead log of document edits for crash recovery
+//
+// Every insert and erase is appended to an in-memory batch as a binary,
+// length-prefixed record
+//   [u32 body length][u32 CRC-32 of body][body: type, sequence, offset, text or count]
+// (integers little-endian or varint). A background writer thread takes the
+// whole batch at once (group commit), writes it with one fwrite and fsyncs
+// at most every syncIntervalMs (0 = after every batch, and the editor wakes
+// the writer on every edit). The editor thread only appends bytes under a
+// short lock, so disk latency stays off the keystroke path.
+// Once snapshotEveryBytes of records have been logged, the full text is
+// handed to the writer with its sequence number; it is written to a
+// temporary file, synced and renamed over `<path>.snapshot`, and the journal
+// is emptied. Recovery loads the snapshot and replays only the records after
+// it, stopping at the first torn or corrupt record (a crash mid-write) or
+// at a gap in the sequence numbers, and cutting off everything from there.
+// A snapshot costs the editor thread O(pieces): it passes the document's
+// piece spans (PieceTable::spans) and the writer streams the text from them.
+class EditJournal {
+public:
+    struct Recovery {
+        size_t snapshotBytes = 0;
+        uint64_t replayed = 0;  // records applied after the snapshot
+        uint64_t skipped = 0;   // records already in the snapshot
+        uint64_t tornBytes = 0; // cut from the end of the journal
+        double elapsedMs = 0;
+    };
+    
+private:
+    enum RecordType : uint8_t { INSERT_RECORD = 1, ERASE_RECORD = 2 };
+    static constexpr char snapshotMagic[8] = {'E', 'D', 'J', 'S', 'N', 'A', 'P', '1'};
+    static constexpr size_t maxPendingBytes = 64 << 20; // the editor waits beyond this
+    static constexpr size_t wakeWriterBytes = 1 << 20;
+    
+    string journalPath, snapshotPath;
+    int syncIntervalMs;
+    size_t snapshotEveryBytes;      // 0 = never snapshot on our own
+    FILE* journalFile = nullptr;
+    thread writer;
+    
+    // Shared with the writer, guarded by lock
+    mutex lock;
+    condition_variable writerWake, editorWake;
+    string pending;                 // serialized records not yet taken by the writer
+    bool snapshotPending = false;
+    PieceTable::Spans snapshotText; // the document at snapshotSequence
+    uint64_t snapshotSequence = 0;
+    size_t snapshotBoundary = 0;    // records in `pending` before it are in the snapshot
+    bool flushRequested = false, stopping = false;
+    atomic<bool> failed{false};     // set on the first write error; nothing is written after it
+    uint64_t loggedSequence = 0, durableSequence = 0;
+    
+    // Editor thread only
+    size_t bytesSinceSnapshot = 0;
+    
+    // Writer statistics
+    atomic<uint64_t> writtenBytes{0}, batches{0}, syncs{0}, snapshots{0};
+    
+    void appendRecord(RecordType type, size_t offset, string_view text, size_t count) {
+        unique_lock<mutex> guard(lock);
+        editorWake.wait(guard, [&] { return pending.size() < maxPendingBytes || failed; });
+        if (failed) return; // the log already has a hole; see writeFailed()
+        bool wasEmpty = pending.empty();
+        size_t start = pending.size();
+        pending.append(8, '\0');
+        pending += (char)type;
+        putVarint(pending, ++loggedSequence);
+        putVarint(pending, offset);
+        if (type == INSERT_RECORD) pending.append(text);
+        else putVarint(pending, count);
+        uint32_t header[2] = {(uint32_t)(pending.size() - start - 8),
+                              crc32(string_view(pending).substr(start + 8))};
+        memcpy(&pending[start], header, sizeof(header));
+        bytesSinceSnapshot += pending.size() - start;
+        bool wake = syncIntervalMs == 0 ? wasEmpty : pending.size() >= wakeWriterBytes && start < wakeWriterBytes;
+        guard.unlock();
+        if (wake) writerWake.notify_one();
+    }
+    
+    bool writeBytes(string_view bytes) {
+        if (bytes.empty()) return true;
+        if (fwrite(bytes.data(), 1, bytes.size(), journalFile) != bytes.size()) return false;
+        writtenBytes += bytes.size();
+        return true;
+    }
+    
+    // Empties the journal once a snapshot covers it. The old handle stays in
+    // use if the journal cannot be reopened.
+    bool restartJournal() {
+        FILE* fresh = fopen(journalPath.c_str(), "wb");
+        if (!fresh) return false;
+        fclose(journalFile);
+        journalFile = fresh;
+        return true;
+    }
+    
+    // Temporary file, sync, then rename: a crash leaves the old or the new snapshot
+    bool writeSnapshot(const PieceTable::Spans& text, uint64_t sequence) {
+        string temporary = snapshotPath + ".tmp";
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if (!file) return false;
+        uint64_t header[2] = {sequence, text.bytes};
+        uint32_t crc = 0;
+        for (string_view slice : text.slices) crc = crc32(slice, crc);
+        bool ok = fwrite(snapshotMagic, 1, sizeof(snapshotMagic), file) == sizeof(snapshotMagic)
+               && fwrite(header, 1, sizeof(header), file) == sizeof(header)
+               && fwrite(&crc, 1, sizeof(crc), file) == sizeof(crc);
+        for (size_t i = 0; ok && i < text.slices.size(); i++) {
+            ok = fwrite(text.slices[i].data(), 1, text.slices[i].size(), file) == text.slices[i].size();
+        }
+        ok = ok && syncToDisk(file);
+        ok = fclose(file) == 0 && ok;
+        error_code error;
+        if (ok) filesystem::rename(temporary, snapshotPath, error);
+        return ok && !error;
+    }
+    
+    void writerLoop() {
+        string batch;
+        PieceTable::Spans text;
+        auto nextSync = steady_clock::now() + milliseconds(syncIntervalMs);
+        bool dirty = false; // written but not yet synced
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            auto ready = [&] { return stopping || flushRequested || !pending.empty() || snapshotPending; };
+            // With an interval, batches are picked up at each sync deadline
+            if (syncIntervalMs == 0) writerWake.wait(guard, ready);
+            else writerWake.wait_until(guard, nextSync, ready);
+            
+            batch.swap(pending);
+            pending.clear();
+            bool takeSnapshot = snapshotPending, flushNow = flushRequested, stopNow = stopping;
+            size_t boundary = snapshotBoundary;
+            uint64_t sequence = snapshotSequence, batchEnd = loggedSequence;
+            if (takeSnapshot) swap(text, snapshotText);
+            snapshotPending = flushRequested = false;
+            guard.unlock();
+            editorWake.notify_all();
+            
+            // After a write error the log has a hole, so later records are
+            // dropped rather than written after it
+            bool ok = !failed;
+            if (ok && takeSnapshot) {
+                // Records up to the snapshot go to the journal first, so a
+                // crash before the rename still recovers them
+                ok = writeBytes(string_view(batch).substr(0, boundary)) && syncToDisk(journalFile)
+                  && writeSnapshot(text, sequence) && restartJournal()
+                  && writeBytes(string_view(batch).substr(boundary));
+                snapshots++;
+            } else if (ok) {
+                ok = writeBytes(batch);
+            }
+            if (takeSnapshot) text = {}; // lets go of buffers the document has dropped
+            if (!batch.empty()) batches++;
+            dirty = dirty || !batch.empty() || takeSnapshot;
+            bool due = syncIntervalMs == 0 || flushNow || stopNow || steady_clock::now() >= nextSync;
+            if (ok && dirty && due) {
+                ok = syncToDisk(journalFile);
+                dirty = false;
+                syncs++;
+            }
+            if (due) nextSync = steady_clock::now() + milliseconds(syncIntervalMs);
+            
+            guard.lock();
+            if (!ok) failed = true;
+            if (!dirty) durableSequence = max(durableSequence, batchEnd);
+            editorWake.notify_all();
+            if (stopNow && pending.empty() && !snapshotPending) break;
+        }
+    }
+    
+public:
+    // Files are `<path>.journal` and `<path>.snapshot`
+    explicit EditJournal(const string& path, int syncInterval = 100, size_t snapshotEvery = 64 << 20)
+        : journalPath(path + ".journal"), snapshotPath(path + ".snapshot"),
+          syncIntervalMs(max(0, syncInterval)), snapshotEveryBytes(snapshotEvery) {}
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+    
+    ~EditJournal() {
+        if (!writer.joinable()) return;
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        writerWake.notify_one();
+        writer.join();
+        fclose(journalFile);
+    }
+    
+    // Loads the last snapshot into the document (anything with load,
+    // insert and eraseRange), replays the journal after it, cuts off a torn
+    // tail and starts the writer. Throws if the files cannot be used.
+    template <typename Document>
+    Recovery open(Document& document) {
+        auto started = high_resolution_clock::now();
+        Recovery recovery;
+        uint64_t sequence = 0;
+        
+        ifstream snapshot(snapshotPath, ios::binary);
+        if (snapshot) {
+            char magic[sizeof(snapshotMagic)];
+            uint64_t header[2];
+            uint32_t crc;
+            snapshot.read(magic, sizeof(magic));
+            snapshot.read(reinterpret_cast<char*>(header), sizeof(header));
+            snapshot.read(reinterpret_cast<char*>(&crc), sizeof(crc));
+            string text;
+            if (snapshot && memcmp(magic, snapshotMagic, sizeof(magic)) == 0 && header[1] <= filesystem::file_size(snapshotPath)) {
+                text.resize(header[1]);
+                snapshot.read(text.data(), text.size());
+            }
+            if (!snapshot || crc32(text) != crc) throw runtime_error("corrupt journal snapshot " + snapshotPath);
+            sequence = header[0];
+            recovery.snapshotBytes = text.size();
+            document.load(std::move(text));
+        } else {
+            document.load("");
+        }
+        
+        string journal;
+        if (ifstream in{journalPath, ios::binary}) journal.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        size_t at = 0;
+        try {
+            while (journal.size() - at >= 8) {
+                uint32_t header[2];
+                memcpy(header, journal.data() + at, sizeof(header));
+                if (header[0] > journal.size() - at - 8) break;
+                string_view body(journal.data() + at + 8, header[0]);
+                if (body.empty() || crc32(body) != header[1]) break;
+                size_t field = 1;
+                uint64_t recordSequence = getVarint(body, field);
+                size_t offset = getVarint(body, field);
+                if (recordSequence <= sequence) {
+                    recovery.skipped++;
+                } else if (recordSequence != sequence + 1) {
+                    break; // records were lost before this one: the rest is unusable
+                } else if (body[0] == INSERT_RECORD && offset <= document.size()) {
+                    document.insert(offset, body.substr(field));
+                } else if (body[0] == ERASE_RECORD && offset <= document.size()) {
+                    size_t count = getVarint(body, field);
+                    if (count > document.size() - offset) break;
+                    document.eraseRange(offset, count);
+                } else {
+                    break;
+                }
+                if (recordSequence == sequence + 1) {
+                    recovery.replayed++;
+                    sequence = recordSequence;
+                }
+                at += 8 + header[0];
+            }
+        } catch (const runtime_error&) {
+            // a truncated varint: the record is torn like any other
+        }
+        recovery.tornBytes = journal.size() - at;
+        if (recovery.tornBytes) filesystem::resize_file(journalPath, at);
+        
+        journalFile = fopen(journalPath.c_str(), "ab");
+        if (!journalFile) throw runtime_error("cannot open journal " + journalPath);
+        loggedSequence = durableSequence = sequence;
+        bytesSinceSnapshot = at;
+        writer = thread(&EditJournal::writerLoop, this);
+        recovery.elapsedMs = duration_cast<microseconds>(high_resolution_clock::now() - started).count() / 1000.0;
+        return recovery;
+    }
+    
+    void logInsert(size_t offset, string_view text) { appendRecord(INSERT_RECORD, offset, text, 0); }
+    void logErase(size_t offset, size_t count) { appendRecord(ERASE_RECORD, offset, {}, count); }
+    
+    bool snapshotDue() const { return snapshotEveryBytes && bytesSinceSnapshot >= snapshotEveryBytes; }
+    
+    // Hands the current text to the writer as piece spans (no copy of the
+    // text here); records logged so far are then no longer needed for recovery
+    void logSnapshot(PieceTable::Spans text) {
+        {
+            lock_guard<mutex> guard(lock);
+            snapshotText = std::move(text);
+            snapshotSequence = loggedSequence;
+            snapshotBoundary = pending.size();
+            snapshotPending = true;
+        }
+        bytesSinceSnapshot = 0;
+        writerWake.notify_one();
+    }
+    
+    // Blocks until everything logged so far is synced; false after a write error
+    bool flush() {
+        unique_lock<mutex> guard(lock);
+        uint64_t target = loggedSequence;
+        flushRequested = true;
+        writerWake.notify_one();
+        editorWake.wait(guard, [&] { return durableSequence >= target || failed; });
+        return !failed;
+    }
+    
+    // True once a write, sync or snapshot failed: changes since then are not logged
+    bool writeFailed() const { return failed; }
+    
+    uint64_t recordCount() const { return loggedSequence; }
+    uint64_t bytesWritten() const { return writtenBytes; }
+    uint64_t batchCount() const { return batches; }
+    uint64_t syncCount() const { return syncs; }
+    uint64_t snapshotCount() const { return snapshots; }
+};
+
+// 📊 EditorDocument: a PieceTable that keeps its word and line counts current.
+// Each insert or erase adjusts the counts from the edited text alone, plus a
+// fix-up for words that join or split at the two edit boundaries:
+//   words(X + T + Y) = words(X + Y) + words(T) - joins(X, T) - joins(T, Y) + joins(X, Y)
+// where joins(A, B) is 1 when A ends and B starts inside a word.
+class EditorDocument {
+    PieceTable pieces;
+    TextStats stats;
+    EditJournal* journal = nullptr; // every change is logged here when set
+    
+    void snapshotIfDue() {
+        if (journal->snapshotDue()) journal->logSnapshot(pieces.spans());
+    }
+    
+    // Change in word count when `text` sits between positions `before` and
+    // `after` of the document (before == after when it is not present yet)
+    long long wordDelta(string_view text, size_t before, size_t after) const {
+        bool leftWord = before > 0 && !isWordSpace(pieces.at(before - 1));
+        bool rightWord = after < pieces.size() && !isWordSpace(pieces.at(after));
+        bool textStartsWord = !isWordSpace(text.front());
+        bool textEndsWord = !isWordSpace(text.back());
+        return (long long)countText(text).words - (leftWord && textStartsWord) - (textEndsWord && rightWord)
+             + (leftWord && rightWord);
+    }
+    
+public:
+    struct Snapshot {
+        PieceTable::Version version;
+        TextStats stats;
+    };
+    
+    void attachJournal(EditJournal* target) { journal = target; }
+    
+    void load(string text) {
+        stats = countText(text);
+        pieces.load(std::move(text));
+        if (journal) journal->logSnapshot(pieces.spans());
+    }
+    
+    void insert(size_t pos, string_view text) {
+        if (text.empty()) return;
+        stats.words += wordDelta(text, pos, pos);
+        stats.newlines += countText(text).newlines;
+        pieces.insert(pos, text);
+        if (!journal) return;
+        journal->logInsert(pos, text);
+        snapshotIfDue();
+    }
+    
+    // `removed` must be the text currently at [pos, pos + removed.size())
+    void erase(size_t pos, string_view removed) {
+        if (removed.empty()) return;
+        stats.words -= wordDelta(removed, pos, pos + removed.size());
+        stats.newlines -= countText(removed).newlines;
+        pieces.erase(pos, removed.size());
+        if (!journal) return;
+        journal->logErase(pos, removed.size());
+        snapshotIfDue();
+    }
+    
+    void eraseRange(size_t pos, size_t count) { erase(pos, pieces.substr(pos, count)); }
+    
+    Snapshot snapshot() { return {pieces.snapshot(), stats}; }
+    
+    // A jump to a saved version cannot be logged as a delta, so the journal
+    // gets a full snapshot
+    void restore(const Snapshot& snapshot) {
+        pieces.restore(snapshot.version);
+        stats = snapshot.stats;
+        if (journal) journal->logSnapshot(pieces.spans());
+    }
+    
+    size_t size() const { return pieces.size(); }
+    bool empty() const { return pieces.empty(); }
+    size_t wordCount() const { return stats.words; }
+    size_t lineCount() const { return pieces.empty() ? 0 : stats.newlines + 1; }
+    const TextStats& statistics() const { return stats; }
+    
+    // Full recount for verification: SSE2 over every slice
+    TextStats recount() const {
+        TextStats fresh;
+        bool afterSpace = true;
+        pieces.forEachSlice([&](string_view slice) { countSlice(slice, afterSpace, fresh); });
+        return fresh;
+    }
+    
+    string substr(size_t from, size_t count) const { return pieces.substr(from, count); }
+    string str() const { return pieces.str(); }
+    void writeTo(ostream& out) const { pieces.writeTo(out); }
+    size_t pieceCount() const { return pieces.pieceCount(); }
+    size_t memoryBytes() const { return pieces.memoryBytes(); }
+    size_t retainedBytes() const { return pieces.retainedBytes(); }
+    
+    template <typename Visitor>
+    void forEachSlice(Visitor fn) const { pieces.forEachSlice(fn); }
+};
+
+enum class EditKind { INSERT, DELETE };
+
+// One reversible edit: what was inserted or deleted, and where
 struct EditorAction {
-    string text;
-    string actionType;
-    string timestamp;
+    EditKind kind;
+    size_t offset;
+    string text; // inserted text, or the text that was deleted
+    
+    EditorAction(EditKind k, size_t at, string affected) : kind(k), offset(at), text(std::move(affected)) {}
+    
+    void apply(EditorDocument& document) const {
+        if (kind == EditKind::INSERT) document.insert(offset, text);
+        else document.erase(offset, text);
+    }
+    
+    void revert(EditorDocument& document) const {
+        if (kind == EditKind::INSERT) document.erase(offset, text);
+        else document.insert(offset, text);
+    }
+    
+    const char* actionType() const { return kind == EditKind::INSERT ? "TYPE" : "DELETE"; }
+    
+    // Bytes held by this entry, including a heap buffer for long text
+    size_t memoryBytes() const {
+        return sizeof(EditorAction) + (text.capacity() > 15 ? text.capacity() + 1 : 0);
+    }
+};
+
+// Saved document version at a given undo depth (an O(1) PieceTable snapshot)
+struct Checkpoint {
+    size_t undoDepth;
+    EditorDocument::Snapshot version;
+};
+
+// 🗜️ Byte-oriented LZ77 in the style of LZ4. Each sequence is a token
+// (literal count and match length - 4, four bits each; 15 means more length
+// bytes follow), the literals, a 2-byte back offset and the extra match
+// length. The final sequence has literals only. Matches are found through a
+// hash table of the last position of each 4-byte prefix.
+string lzCompress(string_view input) {
+    string out;
+    out.reserve(input.size() / 2 + 16);
+    vector<uint32_t> lastSeen(1 << 12, UINT32_MAX);
+    auto read32 = [&](size_t at) {
+        uint32_t v;
+        memcpy(&v, input.data() + at, 4);
+        return v;
+    };
+    auto putLength = [&](size_t extra) {
+        for (; extra >= 255; extra -= 255) out += (char)255;
+        out += (char)extra;
+    };
+    size_t anchor = 0, i = 0;
+    while (i + 4 <= input.size()) {
+        uint32_t slot = (read32(i) * 2654435761u) >> 20;
+        uint32_t candidate = lastSeen[slot];
+        lastSeen[slot] = (uint32_t)i;
+        if (candidate == UINT32_MAX || i - candidate > 0xFFFF || read32(candidate) != read32(i)) {
+            i++;
+            continue;
+        }
+        size_t length = 4;
+        while (i + length < input.size() && input[candidate + length] == input[i + length]) length++;
+        size_t literals = i - anchor, offset = i - candidate;
+        out += (char)((min<size_t>(literals, 15) << 4) | min<size_t>(length - 4, 15));
+        if (literals >= 15) putLength(literals - 15);
+        out.append(input.data() + anchor, literals);
+        out += (char)(offset & 0xFF);
+        out += (char)(offset >> 8);
+        if (length - 4 >= 15) putLength(length - 4 - 15);
+        i += length;
+        anchor = i;
+    }
+    size_t literals = input.size() - anchor;
+    out += (char)(min<size_t>(literals, 15) << 4);
+    if (literals >= 15) putLength(literals - 15);
+    out.append(input.data() + anchor, literals);
+    return out;
+}
+
+string lzDecompress(string_view input, size_t rawSize) {
+    string out;
+    out.reserve(rawSize);
+    size_t i = 0;
+    auto getLength = [&](size_t length) {
+        if (length < 15) return length;
+        uint8_t byte;
+        do {
+            if (i >= input.size()) throw runtime_error("corrupt LZ block");
+            byte = input[i++];
+            length += byte;
+        } while (byte == 255);
+        return length;
+    };
+    while (i < input.size()) {
+        uint8_t token = input[i++];
+        size_t literals = getLength(token >> 4);
+        if (literals > input.size() - i) throw runtime_error("corrupt LZ block");
+        out.append(input.data() + i, literals);
+        i += literals;
+        if (i == input.size()) break;
+        if (input.size() - i < 2) throw runtime_error("corrupt LZ block");
+        size_t offset = (uint8_t)input[i] | (size_t)(uint8_t)input[i + 1] << 8;
+        i += 2;
+        size_t length = getLength(token & 15) + 4;
+        if (offset == 0 || offset > out.size() || out.size() + length > rawSize) throw runtime_error("corrupt LZ block");
+        for (size_t from = out.size() - offset, k = 0; k < length; k++) out += out[from + k];
+    }
+    if (out.size() != rawSize) throw runtime_error("corrupt LZ block");
+    return out;
+}
+
+// 🗄️ EditHistory: undo/redo units under an optional memory budget
+//
+// Consecutive one-character typing (or backspacing) at adjacent positions
+// is coalesced into one unit, split where a new word starts, so undo takes
+// back a word rather than a letter. Over the byte budget, history is shed
+// oldest first:
+//  - with a spill log, the older half of the in-memory units is serialized,
+//    LZ-compressed and appended to a file, and read back when undo gets there;
+//  - otherwise everything below the oldest checkpoint is compacted into one
+//    unit that jumps between two snapshots, and if that is still too much the
+//    compacted unit, then the oldest deltas, are dropped.
+// Memory counts delta text, checkpoint handles and the piece nodes that only
+// saved versions keep alive. The redo side is never shed: it only holds what
+// was undone since the last edit. The document must outlive the history.
+class EditHistory {
+    enum class Compacted { NONE, UNDOABLE, REDOABLE };
+    
+    // Written after each block's data, so the log can be read back from
+    // its end without an index in memory
+    struct SpillTrailer {
+        uint64_t storedBytes;
+        uint64_t rawBytes;
+        uint64_t units;
+    };
+    
+    deque<EditorAction> undoUnits;  // in memory, oldest first
+    vector<EditorAction> redoUnits; // next redo at the back
+    vector<Checkpoint> checkpoints; // ascending undoDepth
+    size_t deltaBytes = 0;          // memoryBytes() of every unit in memory
+    bool sealed = true;             // the newest unit must not grow any more
+    bool topIsTyping = false;       // the newest unit started as one character
+    size_t checkpointEvery;         // 0 = no checkpoints
+    size_t maxCheckpoints;          // oldest are dropped beyond this
+    size_t unitsSinceCheckpoint = 0;
+    size_t byteBudget = 0;          // 0 = unbounded
+    size_t coalesceLimit = 64;      // longest coalesced unit; 0 = no coalescing
+    
+    // Version before the oldest unit, and where the compacted unit ends
+    EditorDocument::Snapshot bottom;
+    bool bottomKnown = false;
+    EditorDocument::Snapshot compactedTo;
+    Compacted compacted = Compacted::NONE;
+    size_t compactedUnits = 0, droppedUnits = 0;
+    
+    fstream spillFile;
+    string spillPath;
+    bool spillEnabled = false;
+    uint64_t spillEnd = 0;          // blocks are a stack: the newest ends here
+    size_t spilledUnits = 0, spilledRawBytes = 0, spillReads = 0;
+    
+    static bool startsWord(char previous, char next) { return isWordSpace(previous) && !isWordSpace(next); }
     
-    EditorAction(string t, string type) : text(t), actionType(type) {
-        auto now = high_resolution_clock::now();
-        auto ms = duration_cast<milliseconds>(now.time_since_epoch());
-        timestamp = to_string(ms.count() % 1000000);
+    // Folds a one-character edit into the newest unit when it continues it
+    bool coalesce(const EditorAction& action) {
+        if (sealed || !topIsTyping || !coalesceLimit || undoUnits.empty() || action.text.size() != 1) return false;
+        EditorAction& top = undoUnits.back();
+        if (top.kind != action.kind || top.text.size() >= coalesceLimit) return false;
+        char c = action.text[0];
+        size_t before = top.memoryBytes();
+        if (action.kind == EditKind::INSERT) {
+            if (action.offset != top.offset + top.text.size() || startsWord(top.text.back(), c)) return false;
+            top.text += c;
+        } else if (action.offset + 1 == top.offset && !startsWord(c, top.text.front())) {
+            top.text.insert(top.text.begin(), c); // backspace
+            top.offset--;
+        } else if (action.offset == top.offset && !startsWord(top.text.back(), c)) {
+            top.text += c; // forward delete
+        } else {
+            return false;
+        }
+        deltaBytes += top.memoryBytes() - before;
+        return true;
+    }
+    
+    void clearRedo() {
+        for (const EditorAction& action : redoUnits) deltaBytes -= action.memoryBytes();
+        redoUnits.clear();
+        if (compacted == Compacted::REDOABLE) {
+            compacted = Compacted::NONE;
+            compactedTo = {};
+            compactedUnits = 0;
+        }
+    }
+    
+    void shiftCheckpoints(size_t removedDepth) {
+        for (Checkpoint& c : checkpoints) c.undoDepth -= removedDepth;
+    }
+    
+    // Folds every unit up to the oldest checkpoint into the compacted unit
+    // (or, if the version before them is unknown, drops them and starts the
+    // history at the checkpoint)
+    void compactOldest() {
+        Checkpoint oldest = std::move(checkpoints.front());
+        checkpoints.erase(checkpoints.begin());
+        size_t below = compacted == Compacted::UNDOABLE ? 1 : 0;
+        for (size_t i = below; i < oldest.undoDepth; i++) {
+            deltaBytes -= undoUnits.front().memoryBytes();
+            undoUnits.pop_front();
+        }
+        if (bottomKnown) {
+            compactedUnits += oldest.undoDepth - below;
+            compactedTo = std::move(oldest.version);
+            compacted = Compacted::UNDOABLE;
+            shiftCheckpoints(oldest.undoDepth - 1);
+        } else {
+            droppedUnits += oldest.undoDepth;
+            bottom = std::move(oldest.version);
+            bottomKnown = true;
+            shiftCheckpoints(oldest.undoDepth);
+        }
+    }
+    
+    void dropCompacted() {
+        bottom = std::move(compactedTo);
+        compactedTo = {};
+        compacted = Compacted::NONE;
+        droppedUnits += compactedUnits;
+        compactedUnits = 0;
+        shiftCheckpoints(1);
+    }
+    
+    void dropOldestUnit() {
+        deltaBytes -= undoUnits.front().memoryBytes();
+        undoUnits.pop_front();
+        droppedUnits++;
+        bottom = {};
+        bottomKnown = false;
+        shiftCheckpoints(1);
+    }
+    
+    // Appends the oldest units in memory to the spill log as one compressed
+    // block, enough to get down to half the budget; the newest unit always
+    // stays in memory
+    bool spillOldest(size_t excessBytes) {
+        string raw;
+        size_t units = 0, freed = 0;
+        while (units + 1 < undoUnits.size() && freed < excessBytes) {
+            const EditorAction& action = undoUnits[units++];
+            raw += action.kind == EditKind::INSERT ? 'I' : 'D';
+            putVarint(raw, action.offset);
+            putVarint(raw, action.text.size());
+            raw += action.text;
+            freed += action.memoryBytes();
+        }
+        string stored = lzCompress(raw);
+        SpillTrailer trailer{stored.size(), raw.size(), units};
+        spillFile.seekp(spillEnd);
+        spillFile.write(stored.data(), stored.size());
+        spillFile.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+        if (!spillFile) {
+            spillFile.clear();
+            spillEnabled = false; // keep what is on disk readable, stop adding to it
+            return false;
+        }
+        spillEnd += stored.size() + sizeof(trailer);
+        spilledUnits += units;
+        spilledRawBytes += raw.size();
+        for (size_t i = 0; i < units; i++) {
+            deltaBytes -= undoUnits.front().memoryBytes();
+            undoUnits.pop_front();
+        }
+        return true;
+    }
+    
+    // Reads the newest spilled block back in below the units in memory
+    void reloadSpilled() {
+        SpillTrailer block;
+        spillFile.seekg(spillEnd - sizeof(block));
+        spillFile.read(reinterpret_cast<char*>(&block), sizeof(block));
+        if (!spillFile || block.storedBytes > spillEnd - sizeof(block) || block.units > spilledUnits) {
+            throw runtime_error("cannot read undo spill log " + spillPath);
+        }
+        uint64_t blockStart = spillEnd - sizeof(block) - block.storedBytes;
+        string stored(block.storedBytes, '\0');
+        spillFile.seekg(blockStart);
+        spillFile.read(stored.data(), stored.size());
+        if (!spillFile) throw runtime_error("cannot read undo spill log " + spillPath);
+        string raw = lzDecompress(stored, block.rawBytes);
+        vector<EditorAction> units;
+        units.reserve(block.units);
+        for (size_t at = 0; at < raw.size();) {
+            EditKind kind = raw[at++] == 'I' ? EditKind::INSERT : EditKind::DELETE;
+            size_t offset = getVarint(raw, at);
+            size_t length = getVarint(raw, at);
+            if (length > raw.size() - at) throw runtime_error("corrupt undo spill log " + spillPath);
+            units.emplace_back(kind, offset, raw.substr(at, length));
+            at += length;
+        }
+        if (units.size() != block.units) throw runtime_error("corrupt undo spill log " + spillPath);
+        for (size_t i = units.size(); i-- > 0;) {
+            deltaBytes += units[i].memoryBytes();
+            undoUnits.push_front(std::move(units[i]));
+        }
+        spillEnd = blockStart;
+        spilledUnits -= block.units;
+        spilledRawBytes -= block.rawBytes;
+        spillReads++;
+    }
+    
+    void enforceBudget(const EditorDocument& document) {
+        while (byteBudget && memoryBytes(document) > byteBudget) {
+            if (spillEnabled && undoUnits.size() > 1 && spillOldest(memoryBytes(document) - byteBudget / 2)) continue;
+            if (spilledUnits) { // units on disk sit below those in memory
+                if (checkpoints.empty()) break;
+                checkpoints.erase(checkpoints.begin());
+            } else if (!checkpoints.empty()) {
+                compactOldest();
+            } else if (compacted == Compacted::UNDOABLE) {
+                dropCompacted();
+            } else if (undoUnits.size() > 1) {
+                dropOldestUnit();
+            } else {
+                break;
+            }
+        }
+    }
+    
+public:
+    explicit EditHistory(size_t checkpointInterval = 0, size_t checkpointLimit = 4)
+        : checkpointEvery(checkpointInterval), maxCheckpoints(checkpointLimit) {}
+    EditHistory(const EditHistory&) = delete;
+    EditHistory& operator=(const EditHistory&) = delete;
+    
+    ~EditHistory() {
+        if (!spillFile.is_open()) return;
+        spillFile.close();
+        remove(spillPath.c_str());
+    }
+    
+    void setBudget(size_t bytes) { byteBudget = bytes; }
+    void setCoalescing(size_t maxUnitBytes) { coalesceLimit = maxUnitBytes; }
+    
+    // Sends history over the budget to a compressed log at path (created or
+    // truncated, and deleted with the history)
+    bool spillTo(const string& path) {
+        if (spillFile.is_open()) return path == spillPath;
+        spillFile.open(path, ios::in | ios::out | ios::binary | ios::trunc);
+        if (!spillFile) return false;
+        spillPath = path;
+        spillEnabled = true;
+        return true;
+    }
+    
+    // Forgets everything; the document's current version becomes the oldest state
+    void reset(EditorDocument& document) {
+        undoUnits.clear();
+        redoUnits.clear();
+        checkpoints.clear();
+        deltaBytes = 0;
+        sealed = true;
+        unitsSinceCheckpoint = 0;
+        bottom = document.snapshot();
+        bottomKnown = true;
+        compactedTo = {};
+        compacted = Compacted::NONE;
+        compactedUnits = droppedUnits = 0;
+        spillEnd = 0;
+        spilledUnits = spilledRawBytes = 0;
+    }
+    
+    // Records an edit already applied to the document: redo history and
+    // checkpoints past this point are stale
+    void record(EditorAction action, EditorDocument& document) {
+        clearRedo();
+        while (!checkpoints.empty() && checkpoints.back().undoDepth > undoDepth()) checkpoints.pop_back();
+        if (!coalesce(action)) {
+            topIsTyping = action.text.size() == 1;
+            deltaBytes += action.memoryBytes();
+            undoUnits.push_back(std::move(action));
+            sealed = false;
+            if (checkpointEvery && ++unitsSinceCheckpoint >= checkpointEvery) {
+                unitsSinceCheckpoint = 0;
+                checkpoints.push_back({undoDepth(), document.snapshot()});
+                sealed = true; // growing the unit would make the checkpoint stale
+                if (checkpoints.size() > maxCheckpoints) checkpoints.erase(checkpoints.begin());
+            }
+        }
+        enforceBudget(document);
+    }
+    
+    // Reverts the newest unit; returns what it was, or nullptr if there is none
+    const char* undo(EditorDocument& document) {
+        sealed = true;
+        if (undoUnits.empty() && spilledUnits) reloadSpilled();
+        if (undoUnits.empty()) {
+            if (compacted != Compacted::UNDOABLE) return nullptr;
+            document.restore(bottom);
+            compacted = Compacted::REDOABLE;
+            return "COMPACTED";
+        }
+        redoUnits.push_back(std::move(undoUnits.back()));
+        undoUnits.pop_back();
+        redoUnits.back().revert(document);
+        return redoUnits.back().actionType();
+    }
+    
+    const char* redo(EditorDocument& document) {
+        sealed = true;
+        if (compacted == Compacted::REDOABLE) {
+            document.restore(compactedTo);
+            compacted = Compacted::UNDOABLE;
+            return "COMPACTED";
+        }
+        if (redoUnits.empty()) return nullptr;
+        undoUnits.push_back(std::move(redoUnits.back()));
+        redoUnits.pop_back();
+        undoUnits.back().apply(document);
+        return undoUnits.back().actionType();
+    }
+    
+    // Undoes `steps` units at once. With a checkpoint inside the range, the
+    // document is restored from it and only the units below it are reverted;
+    // the skipped units still move to the redo side. This wins when the
+    // skipped edits are spread through a large document.
+    void undoMany(size_t steps, EditorDocument& document) {
+        size_t target = undoDepth() - min(steps, undoDepth());
+        auto usable = find_if(checkpoints.begin(), checkpoints.end(),
+                              [&](const Checkpoint& c) { return c.undoDepth >= target && c.undoDepth < undoDepth(); });
+        if (usable != checkpoints.end()) {
+            while (undoDepth() > usable->undoDepth) {
+                if (undoUnits.empty()) reloadSpilled();
+                redoUnits.push_back(std::move(undoUnits.back()));
+                undoUnits.pop_back();
+            }
+            document.restore(usable->version);
+        }
+        while (undoDepth() > target) undo(document);
+        sealed = true;
+    }
+    
+    size_t undoDepth() const { return (compacted == Compacted::UNDOABLE) + spilledUnits + undoUnits.size(); }
+    size_t redoDepth() const { return (compacted == Compacted::REDOABLE) + redoUnits.size(); }
+    size_t residentUnits() const { return undoUnits.size() + redoUnits.size(); }
+    size_t checkpointCount() const { return checkpoints.size(); }
+    size_t compactedCount() const { return compactedUnits; }
+    size_t droppedCount() const { return droppedUnits; }
+    size_t spilledCount() const { return spilledUnits; }
+    size_t spilledRaw() const { return spilledRawBytes; }
+    size_t spilledOnDisk() const { return spillEnd; }
+    size_t spillReloads() const { return spillReads; }
+    
+    // Bytes held in memory for the history: units, checkpoint handles and
+    // piece nodes kept alive only by saved versions
+    size_t memoryBytes(const EditorDocument& document) const {
+        return deltaBytes + checkpoints.capacity() * sizeof(Checkpoint) + document.retainedBytes();
     }
 };
 
 class TextEditor {
 private:
-    stack<EditorAction> undoStack;
-    stack<EditorAction> redoStack;
-    string currentText;
+    EditorDocument document;
+    EditHistory history; // destroyed before the document: its snapshots point into it
+    unique_ptr<EditJournal> journal;
     int totalOperations;
-    vector<string> operationHistory;
+    deque<string> operationHistory; // newest entries for the interactive demo
+    size_t loggedOperations;
+    bool verbose;
+    bool journalFailureReported = false;
+    static constexpr size_t maxLoggedOperations = 64;
+    
+    void logOperation(string entry) {
+        operationHistory.push_back(std::move(entry));
+        loggedOperations++;
+        if (operationHistory.size() > maxLoggedOperations) operationHistory.pop_front();
+        if (journal && journal->writeFailed() && !journalFailureReported) {
+            journalFailureReported = true;
+            if (verbose) cout << "❌ Journal write failed: changes are no longer being saved\n";
+        }
+    }
 
 public:
-    TextEditor() : currentText(""), totalOperations(0) {
+    explicit TextEditor(bool verboseOutput = true, size_t checkpointInterval = 0, size_t checkpointLimit = 4)
+        : history(checkpointInterval, checkpointLimit), totalOperations(0), loggedOperations(0), verbose(verboseOutput) {
+        history.reset(document);
+        if (!verbose) return;
         cout << "=== 🧱 Text Editor with Stack-based Undo/Redo ===\n\n";
         cout << "📝 Starting new document...\n";
     }
+    
+    // Starts from existing content; earlier history no longer applies
+    void load(string text) {
+        document.load(std::move(text));
+        history.reset(document);
+    }
+    
+    // Keeps undo history within `bytes` (0 = unbounded); see EditHistory
+    void limitHistory(size_t bytes) { history.setBudget(bytes); }
+    bool spillHistoryTo(const string& path) { return history.spillTo(path); }
+    
+    // Recovers the document from the journal at path (empty if there is
+    // none) and logs every later change to it. Undo history starts fresh.
+    bool openJournal(const string& path, int syncIntervalMs = 100, size_t snapshotEveryBytes = 64 << 20) {
+        document.attachJournal(nullptr);
+        journal.reset();
+        auto opened = make_unique<EditJournal>(path, syncIntervalMs, snapshotEveryBytes);
+        try {
+            EditJournal::Recovery recovery = opened->open(document);
+            if (verbose) {
+                cout << "📓 Recovered " << document.size() << " characters from " << path << " (snapshot "
+                     << recovery.snapshotBytes << " bytes + " << recovery.replayed << " journal records";
+                if (recovery.tornBytes) cout << ", " << recovery.tornBytes << " torn bytes cut";
+                cout << ") in " << recovery.elapsedMs << " ms\n";
+            }
+        } catch (const exception& error) {
+            if (verbose) cout << "❌ Cannot open journal: " << error.what() << "\n";
+            history.reset(document);
+            return false;
+        }
+        journal = std::move(opened);
+        journalFailureReported = false;
+        document.attachJournal(journal.get());
+        history.reset(document);
+        return true;
+    }
+    
+    // Waits until every change so far is on disk
+    bool syncJournal() { return !journal || journal->flush(); }
+    const EditJournal* editJournal() const { return journal.get(); }
+    void setTypingCoalescing(size_t maxUnitBytes) { history.setCoalescing(maxUnitBytes); }
 
-    void type(const string& text) {
-        // Save current state before making changes
-        undoStack.push(EditorAction(currentText, "TYPE"));
-        currentText += text;
+    void insertAt(size_t offset, const string& text) {
+        if (offset > document.size()) {
+            if (verbose) cout << "❌ Cannot insert at " << offset << " (length " << document.size() << ")\n";
+            return;
+        }
+        EditorAction action(EditKind::INSERT, offset, text);
+        action.apply(document);
+        history.record(std::move(action), document);
         totalOperations++;
         
-        // Clear redo stack when new action is performed
-        while (!redoStack.empty()) redoStack.pop();
-        
-        operationHistory.push_back("TYPED: '" + text + "'");
-        
+        if (!verbose) return;
+        logOperation("TYPED: '" + text + "'");
         cout << "✍️ Typed: \"" << text << "\"\n";
         showStatus();
     }
 
-    void deleteLast(int count = 1) {
-        if (currentText.length() < count) {
-            cout << "❌ Cannot delete " << count << " characters (only " 
-                 << currentText.length() << " available)\n";
+    void deleteRange(size_t offset, size_t count) {
+        if (offset > document.size() || document.size() - offset < count) {
+            if (verbose) cout << "❌ Cannot delete " << count << " characters (only "
+                              << document.size() - min(offset, document.size()) << " available)\n";
             return;
         }
+        EditorAction action(EditKind::DELETE, offset, document.substr(offset, count));
+        action.apply(document);
         
-        undoStack.push(EditorAction(currentText, "DELETE"));
-        string deleted = currentText.substr(currentText.length() - count);
-        currentText = currentText.substr(0, currentText.length() - count);
+        if (verbose) {
+            logOperation("DELETED: '" + action.text + "'");
+            cout << "🗑️ Deleted: \"" << action.text << "\"\n";
+        }
+        history.record(std::move(action), document);
         totalOperations++;
-        
-        while (!redoStack.empty()) redoStack.pop();
-        
-        operationHistory.push_back("DELETED: '" + deleted + "'");
-        
-        cout << "🗑️ Deleted: \"" << deleted << "\"\n";
-        showStatus();
+        if (verbose) showStatus();
+    }
+
+    void type(const string& text) {
+        insertAt(document.size(), text);
+    }
+
+    void deleteLast(int count = 1) {
+        if (count < 0 || document.size() < (size_t)count) {
+            if (verbose) cout << "❌ Cannot delete " << count << " characters (only " 
+                 << document.size() << " available)\n";
+            return;
+        }
+        deleteRange(document.size() - count, count);
     }
 
     void undo() {
-        if (undoStack.empty()) {
-            cout << "❌ Nothing to undo!\n";
+        const char* restored = history.undo(document);
+        if (!restored) {
+            if (verbose) cout << "❌ Nothing to undo!\n";
             return;
         }
-        
-        EditorAction lastAction = undoStack.top();
-        undoStack.pop();
-        
-        // Save current state to redo stack
-        redoStack.push(EditorAction(currentText, "UNDO_POINT"));
-        
-        // Restore previous state
-        currentText = lastAction.text;
         totalOperations++;
         
-        operationHistory.push_back("UNDO: " + lastAction.actionType);
-        
-        cout << "↩️ Undo performed (restored " << lastAction.actionType << ")\n";
+        if (!verbose) return;
+        logOperation(string("UNDO: ") + restored);
+        cout << "↩️ Undo performed (restored " << restored << ")\n";
         showStatus();
         showStackSizes();
     }
 
     void redo() {
-        if (redoStack.empty()) {
-            cout << "❌ Nothing to redo!\n";
+        if (!history.redo(document)) {
+            if (verbose) cout << "❌ Nothing to redo!\n";
             return;
         }
-        
-        EditorAction redoAction = redoStack.top();
-        redoStack.pop();
-        
-        // Save current state to undo stack
-        undoStack.push(EditorAction(currentText, "REDO_POINT"));
-        
-        // Restore redo state
-        currentText = redoAction.text;
         totalOperations++;
         
-        operationHistory.push_back("REDO: restored state");
-        
+        if (!verbose) return;
+        logOperation("REDO: restored state");
         cout << "↪️ Redo performed\n";
         showStatus();
         showStackSizes();
     }
+    
+    // Undoes `steps` edits at once, jumping through a checkpoint when one is
+    // inside the range (see EditHistory::undoMany)
+    void undoMany(size_t steps) {
+        steps = min(steps, history.undoDepth());
+        history.undoMany(steps, document);
+        totalOperations += steps;
+        if (verbose) {
+            cout << "⏪ Undid " << steps << " operations\n";
+            showStatus();
+        }
+    }
+    
+    // Character-by-character rescan (what every status line used to cost),
+    // kept as the benchmark baseline
+    size_t scanWordCount() const {
+        if (document.empty()) return 0;
+        
+        size_t words = 0;
+        bool inWord = false;
+        
+        document.forEachSlice([&](string_view slice) {
+            for (char c : slice) {
+                if (c != ' ' && c != '\t' && c != '\n') {
+                    if (!inWord) {
+                        words++;
+                        inWord = true;
+                    }
+                } else {
+                    inWord = false;
+                }
+            }
+        });
+        
+        return words;
+    }
+
+    // Incremental counts against a full SIMD recount
+    bool verifyStatistics() const { return document.recount() == document.statistics(); }
+    size_t wordCount() const { return document.wordCount(); }
+    size_t lineCount() const { return document.lineCount(); }
+    
+    string text() const { return document.str(); }
+    size_t length() const { return document.size(); }
+    size_t pieceCount() const { return document.pieceCount(); }
+    size_t undoDepth() const { return history.undoDepth(); }
+    size_t redoDepth() const { return history.redoDepth(); }
+    size_t checkpointCount() const { return history.checkpointCount(); }
+    const EditHistory& editHistory() const { return history; }
+    
+    // Bytes held in memory by undo/redo history, including piece nodes that
+    // only checkpoints keep alive
+    size_t historyMemory() const { return history.memoryBytes(document); }
 
     void showStatus() {
-        cout << "📄 Current Text: \"" << currentText << "\"\n";
-        cout << "📊 Characters: " << currentText.length() << " | Words: " << countWords() << "\n";
+        cout << "📄 Current Text: \"";
+        document.writeTo(cout);
+        cout << "\"\n";
+        cout << "📊 Characters: " << document.size() << " | Words: " << countWords() << "\n";
         cout << "────────────────────────────────────────\n";
     }
 
     void showStackSizes() {
         cout << "🔢 Stack Status:\n";
-        cout << "   ↩️ Undo Stack: " << undoStack.size() << " operations\n";
-        cout << "   ↪️ Redo Stack: " << redoStack.size() << " operations\n";
+        cout << "   ↩️ Undo Stack: " << history.undoDepth() << " operations\n";
+        cout << "   ↪️ Redo Stack: " << history.redoDepth() << " operations\n";
         cout << "────────────────────────────────────────\n";
     }
 
@@ -147,8 +1553,9 @@ public:
         cout << "│ #  │ Operation                                    │\n";
         cout << "├────┼──────────────────────────────────────────────┤\n";
         
+        size_t first = loggedOperations - operationHistory.size();
         for (size_t i = 0; i < operationHistory.size(); i++) {
-            cout << "│ " << left << setw(2) << (i + 1) << " │ " 
+            cout << "│ " << left << setw(2) << (first + i + 1) << " │ " 
                  << left << setw(48) << operationHistory[i] << "│\n";
         }
         cout << "└────┴──────────────────────────────────────────────┘\n";
@@ -157,11 +1564,22 @@ public:
     void showStatistics() {
         cout << "\n📈 Editor Statistics:\n";
         cout << "├── Total Operations: " << totalOperations << endl;
-        cout << "├── Current Document Length: " << currentText.length() << " characters" << endl;
+        cout << "├── Current Document Length: " << document.size() << " characters" << endl;
         cout << "├── Word Count: " << countWords() << endl;
-        cout << "├── Undo Stack Depth: " << undoStack.size() << endl;
-        cout << "├── Redo Stack Depth: " << redoStack.size() << endl;
-        cout << "└── Memory Usage: ~" << calculateMemoryUsage() << " bytes" << endl;
+        cout << "├── Line Count: " << document.lineCount() << endl;
+        cout << "├── Undo Stack Depth: " << history.undoDepth() << endl;
+        cout << "├── Redo Stack Depth: " << history.redoDepth() << endl;
+        if (history.spilledCount() || history.compactedCount() || history.droppedCount()) {
+            cout << "├── History Shed: " << history.spilledCount() << " spilled (" << history.spilledOnDisk()
+                 << " bytes on disk), " << history.compactedCount() << " compacted, " << history.droppedCount() << " dropped" << endl;
+        }
+        if (journal) {
+            cout << "├── Journal: " << journal->recordCount() << " records, "
+                 << (journal->writeFailed() ? "❌ write failed, changes not saved" : "✅ writing") << endl;
+        }
+        size_t documentBytes = document.memoryBytes() - document.retainedBytes();
+        cout << "└── Memory Usage: " << documentBytes + historyMemory() + logMemory() << " bytes (document "
+             << documentBytes << ", history " << historyMemory() << ", log " << logMemory() << ")" << endl;
     }
 
     void demonstrateStackConcepts() {
@@ -182,36 +1600,451 @@ public:
     }
 
 private:
-    int countWords() const {
-        if (currentText.empty()) return 0;
-        
-        int words = 0;
-        bool inWord = false;
+    // Maintained incrementally by EditorDocument, so O(1) per status line
+    size_t countWords() const {
+        return document.wordCount();
+    }
+
+    size_t logMemory() const {
+        size_t usage = 0;
+        for (const string& entry : operationHistory) usage += sizeof(string) + (entry.capacity() > 15 ? entry.capacity() + 1 : 0);
+        return usage;
+    }
+};
+
+// Counts what is written to it; lets the streaming benchmark skip real I/O
+class CountingBuffer : public streambuf {
+public:
+    size_t bytes = 0;
+    
+protected:
+    streamsize xsputn(const char*, streamsize n) override {
+        bytes += n;
+        return n;
+    }
+    int_type overflow(int_type c) override {
+        bytes++;
+        return c;
+    }
+};
+
+// Nanoseconds taken by one call of fn
+template <typename Fn>
+double timed(Fn&& fn) {
+    auto t0 = high_resolution_clock::now();
+    fn();
+    return (double)duration_cast<nanoseconds>(high_resolution_clock::now() - t0).count();
+}
+
+// Latency summary of a set of timings in ns (sorts them)
+string percentiles(vector<double>& ns) {
+    if (ns.empty()) return "no samples";
+    sort(ns.begin(), ns.end());
+    auto at = [&](double p) { return ns[min(ns.size() - 1, (size_t)(p / 100 * ns.size()))]; };
+    ostringstream out;
+    out << fixed << setprecision(0) << "p50 " << at(50) << " ns, p99 " << at(99) << " ns, p99.9 " << at(99.9)
+        << " ns, max " << ns.back() / 1000 << " us";
+    return out.str();
+}
+
+// Delta history vs the old full-snapshot history on a large document:
+// per-operation latency percentiles and memory held by undo/redo
+void runBenchmark(size_t megabytes, int edits) {
+    cout << "=== 🧱 Undo/Redo Benchmark (" << megabytes << " MB document, " << edits << " edits) ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    string document(megabytes << 20, ' ');
+    mt19937 rng(42);
+    for (char& c : document) c = (rng() % 6) ? (char)('a' + rng() % 26) : ' ';
+    
+    // Typing session: mostly short inserts with some deletes, then undo/redo bursts
+    auto session = [&](TextEditor& editor, vector<double>& editNs, vector<double>& undoNs, vector<double>& redoNs) {
+        const string words[] = {"the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dogs "};
+        for (int i = 0; i < edits; i++) {
+            int r = rng() % 10;
+            if (r < 7) editNs.push_back(timed([&] { editor.type(words[rng() % 8]); }));
+            else if (r < 9) editNs.push_back(timed([&] { editor.deleteLast(1 + rng() % 5); }));
+            else {
+                int burst = 1 + rng() % 8;
+                for (int k = 0; k < burst; k++) undoNs.push_back(timed([&] { editor.undo(); }));
+                for (int k = 0; k < burst / 2; k++) redoNs.push_back(timed([&] { editor.redo(); }));
+            }
+        }
+    };
+    
+    TextEditor editor(false);
+    editor.load(document);
+    vector<double> editNs, undoNs, redoNs;
+    double totalMs = timed([&] { session(editor, editNs, undoNs, redoNs); }) / 1e6;
+    cout << "📝 Delta history (" << totalMs << " ms total):\n";
+    cout << "├── Edits: " << percentiles(editNs) << "\n";
+    cout << "├── Undo:  " << percentiles(undoNs) << "\n";
+    cout << "├── Redo:  " << percentiles(redoNs) << "\n";
+    cout << "└── History memory: " << editor.historyMemory() / 1048576.0 << " MB for "
+         << editor.undoDepth() + editor.redoDepth() << " deltas ("
+         << (double)editor.historyMemory() / max<size_t>(1, editor.undoDepth() + editor.redoDepth()) << " bytes each)\n\n";
+    
+    // Long jump back with and without checkpoints
+    size_t jump = editor.undoDepth();
+    double plainMs = timed([&] { editor.undoMany(jump); }) / 1e6;
+    
+    // Checkpoints pay off when deltas sit mid-document: each revert then
+    // moves the text after its offset, while a restore is one copy
+    const int midEdits = min(edits, 200), interval = max(1, midEdits / 4);
+    auto midSession = [&](TextEditor& target) {
+        mt19937 positions(7);
+        target.load(document);
+        for (int i = 0; i < midEdits; i++) target.insertAt(positions() % target.length(), "mid-document edit ");
+    };
+    TextEditor checkpointed(false, interval), replayed(false);
+    midSession(checkpointed);
+    midSession(replayed);
+    double toCheckpointMs = timed([&] { checkpointed.undoMany(midEdits - interval); }) / 1e6;
+    double replayMs = timed([&] { replayed.undoMany(midEdits - interval); }) / 1e6;
+    cout << "⏪ undoMany:\n";
+    cout << "├── Whole session (" << jump << " deltas at the end): " << plainMs << " ms, document restored: "
+         << (editor.text() == document ? "✅" : "⚠️ differs") << "\n";
+    cout << "├── " << midEdits - interval << " of " << midEdits << " random-position inserts, replaying deltas: " << replayMs << " ms\n";
+    cout << "└── Same jump via checkpoint (every " << interval << " ops, " << checkpointed.checkpointCount() << " kept, +"
+         << (checkpointed.historyMemory() - replayed.historyMemory()) / 1048576.0 << " MB): " << toCheckpointMs
+         << " ms, same text: " << (checkpointed.text() == replayed.text() ? "✅" : "⚠️") << "\n\n";
+    
+    // The old model copied the whole document onto a stack for every operation
+    const int snapshotOps = 8;
+    vector<double> snapshotNs;
+    {
+        stack<string> snapshots;
+        string current = document;
+        for (int i = 0; i < snapshotOps; i++) {
+            snapshotNs.push_back(timed([&] {
+                snapshots.push(current);
+                current += "word ";
+            }));
+        }
+    }
+    cout << "📸 Full-snapshot history (previous design, " << snapshotOps << " ops measured):\n";
+    cout << "├── Per edit: " << percentiles(snapshotNs) << "\n";
+    cout << "└── Memory for " << edits << " edits: ~" << (double)document.size() * edits / (1ull << 40)
+         << " TB (one document copy per operation)\n";
+}
+
+// Random-position edits on a large document: PieceTable vs one std::string
+void runPieceTableBenchmark(size_t megabytes, int edits) {
+    cout << "=== 🧩 Piece Table vs std::string (" << megabytes << " MB document) ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    // Build the document from a repeated random block (fast to generate)
+    string block(1 << 16, ' ');
+    mt19937 rng(42);
+    for (char& c : block) c = (rng() % 6) ? (char)('a' + rng() % 26) : ' ';
+    string document;
+    document.reserve((megabytes << 20) + (1 << 20));
+    while (document.size() < (megabytes << 20)) document += block;
+    
+    // Same edit stream for both models: insert or delete 1-16 characters at a random offset
+    auto edit = [](auto& doc, size_t length, mt19937& r) {
+        size_t offset = r() % (length + 1);
+        size_t count = 1 + r() % 16;
+        if (r() & 1) {
+            doc.insert(offset, string_view("0123456789abcdef", count));
+            return length + count;
+        }
+        count = min(count, length - min(offset, length));
+        doc.erase(offset, count);
+        return length - count;
+    };
+    
+    PieceTable pieces;
+    pieces.load(document);
+    vector<double> pieceNs;
+    pieceNs.reserve(edits);
+    mt19937 editRng(7);
+    size_t length = pieces.size();
+    double snapshotNs = 0;
+    for (int i = 0; i < edits; i++) {
+        pieceNs.push_back(timed([&] { length = edit(pieces, length, editRng); }));
+        if (i % 1000 == 0) snapshotNs += timed([&] { PieceTable::Version v = pieces.snapshot(); });
+    }
+    
+    const int stringEdits = min(edits, 20);
+    vector<double> stringNs;
+    editRng.seed(7);
+    length = document.size();
+    for (int i = 0; i < stringEdits; i++) stringNs.push_back(timed([&] { length = edit(document, length, editRng); }));
+    
+    cout << "✏️ Random-position edits:\n";
+    cout << "├── PieceTable (" << edits << " edits):  " << percentiles(pieceNs) << "\n";
+    cout << "├── std::string (" << stringEdits << " edits):    " << percentiles(stringNs) << "\n";
+    cout << "└── Snapshot: " << snapshotNs / max(1, edits / 1000 + 1) << " ns each, " << pieces.pieceCount()
+         << " pieces, " << pieces.memoryBytes() / 1048576.0 << " MB total\n\n";
+    
+    CountingBuffer sink;
+    ostream out(&sink);
+    double pieceStreamMs = timed([&] { pieces.writeTo(out); }) / 1e6;
+    size_t pieceBytes = sink.bytes;
+    size_t materialized = 0;
+    double materializeMs = timed([&] { materialized = pieces.str().size(); }) / 1e6;
+    cout << "📤 Producing the whole document:\n";
+    cout << "├── writeTo (streamed slice by slice): " << pieceStreamMs << " ms for " << pieceBytes / 1048576.0
+         << " MB, no extra memory\n";
+    cout << "└── str() (materialized copy):         " << materializeMs << " ms, +" << materialized / 1048576.0 << " MB\n";
+}
+
+// Keystroke latency including the word count shown after every keystroke:
+// incremental counts vs a scalar rescan (the old behaviour) vs an SSE2 recount
+void runKeystrokeBenchmark(size_t megabytes, int keystrokes) {
+    cout << "=== ⌨️ Keystroke Latency with Live Statistics (" << megabytes << " MB document) ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    string block(1 << 16, ' ');
+    mt19937 rng(42);
+    for (char& c : block) {
+        int r = rng() % 40;
+        c = r < 6 ? ' ' : r == 6 ? '\n' : (char)('a' + rng() % 26);
+    }
+    string document;
+    document.reserve(megabytes << 20);
+    while (document.size() < (megabytes << 20)) document += block;
+    
+    TextEditor editor(false);
+    editor.load(document);
+    size_t cursor = editor.length() / 2;
+    const char keys[] = "the quick brown fox\njumps ";
+    size_t shown = 0;
+    // One keystroke: type at the cursor (sometimes jumping elsewhere), then read the word count
+    auto keystroke = [&](auto&& wordCount) {
+        if (rng() % 64 == 0) cursor = rng() % editor.length();
+        if (rng() % 8 == 0 && cursor > 0) editor.deleteRange(--cursor, 1);
+        else editor.insertAt(cursor++, string(1, keys[rng() % (sizeof(keys) - 1)]));
+        shown += wordCount();
+    };
+    
+    vector<double> incrementalNs, scanNs, simdNs;
+    incrementalNs.reserve(keystrokes);
+    for (int i = 0; i < keystrokes; i++) incrementalNs.push_back(timed([&] { keystroke([&] { return editor.wordCount(); }); }));
+    const int rescans = 10;
+    for (int i = 0; i < rescans; i++) scanNs.push_back(timed([&] { keystroke([&] { return editor.scanWordCount(); }); }));
+    bool consistent = true;
+    for (int i = 0; i < rescans; i++) simdNs.push_back(timed([&] {
+        keystroke([&] {
+            consistent = consistent && editor.verifyStatistics();
+            return editor.wordCount();
+        });
+    }));
+    
+    cout << "⌨️ Keystroke + word count (" << editor.pieceCount() << " pieces after the session):\n";
+    cout << "├── Incremental counts (" << keystrokes << " keys): " << percentiles(incrementalNs) << "\n";
+    cout << "├── Scalar rescan (" << rescans << " keys):        " << percentiles(scanNs) << "\n";
+    cout << "└── SSE2 recount (" << rescans << " keys):         " << percentiles(simdNs) << "\n\n";
+    
+    double scalarMs = timed([&] { shown += editor.scanWordCount(); }) / 1e6;
+    double simdMs = timed([&] { shown += editor.verifyStatistics(); }) / 1e6;
+    double mb = editor.length() / 1048576.0;
+    cout << "🔎 Full recount of " << mb << " MB: scalar " << scalarMs << " ms (" << mb / scalarMs * 1000
+         << " MB/s), SSE2 " << simdMs << " ms (" << mb / simdMs * 1000 << " MB/s)\n";
+    cout << "✅ Incremental counts match the recount: " << (consistent && editor.verifyStatistics() ? "yes" : "⚠️ no")
+         << " (" << editor.wordCount() << " words, " << editor.lineCount() << " lines)\n";
+    if (shown == 0) cout << "\n";
+}
+
+// A long typing session under a history budget: shedding by compaction or
+// by spilling to disk, against unbounded history
+void runHistoryBenchmark(size_t budgetKB, int keystrokes) {
+    cout << "=== 🗄️ Bounded Undo History (" << budgetKB << " KB budget, " << keystrokes << " keystrokes) ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    string document(10 << 20, ' ');
+    mt19937 textRng(42);
+    for (char& c : document) c = (textRng() % 6) ? (char)('a' + textRng() % 26) : ' ';
+    
+    string spillPath = (filesystem::temp_directory_path() / "stack_text_editor_undo.log").string();
+    const char* names[] = {"Unbounded", "Compaction", "Spill to disk"};
+    for (int mode = 0; mode < 3; mode++) {
+        TextEditor editor(false, mode == 1 ? 256 : 0, 8);
+        editor.load(document);
+        if (mode > 0) editor.limitHistory(budgetKB << 10);
+        if (mode == 2 && !editor.spillHistoryTo(spillPath)) {
+            cout << "❌ Cannot open " << spillPath << "\n";
+            continue;
+        }
         
-        for (char c : currentText) {
-            if (c != ' ' && c != '\t' && c != '\n') {
-                if (!inWord) {
-                    words++;
-                    inWord = true;
+        // Typing with backspaces, occasional pastes and cursor jumps
+        mt19937 rng(7);
+        const char keys[] = "the quick brown fox\njumps ";
+        size_t cursor = editor.length() / 2;
+        vector<double> keyNs;
+        keyNs.reserve(keystrokes);
+        size_t peakMemory = 0;
+        for (int i = 0; i < keystrokes; i++) {
+            if (rng() % 256 == 0) cursor = rng() % editor.length();
+            int r = rng() % 100;
+            keyNs.push_back(timed([&] {
+                if (r < 12 && cursor > 0) editor.deleteRange(--cursor, 1);
+                else if (r == 99) {
+                    editor.insertAt(cursor, "pasted paragraph of text\n");
+                    cursor += 25;
+                } else {
+                    editor.insertAt(cursor++, string(1, keys[rng() % (sizeof(keys) - 1)]));
                 }
-            } else {
-                inWord = false;
-            }
+            }));
+            if (i % 1024 == 0) peakMemory = max(peakMemory, editor.historyMemory());
         }
         
-        return words;
+        const EditHistory& history = editor.editHistory();
+        string finalText = editor.text();
+        size_t depth = editor.undoDepth();
+        cout << "📝 " << names[mode] << ":\n";
+        cout << "├── Keystrokes: " << percentiles(keyNs) << "\n";
+        cout << "├── Undo units: " << depth << " (" << (double)keystrokes / max<size_t>(1, depth) << " keystrokes each)\n";
+        cout << "├── History memory: " << editor.historyMemory() / 1024.0 << " KB (peak sampled " << peakMemory / 1024.0 << " KB)\n";
+        if (mode == 1) {
+            cout << "├── Compacted " << history.compactedCount() << " units into a checkpoint jump, dropped "
+                 << history.droppedCount() << "\n";
+        }
+        if (mode == 2) {
+            cout << "├── Spilled " << history.spilledCount() << " units: " << history.spilledRaw() / 1024.0 << " KB serialized, "
+                 << history.spilledOnDisk() / 1024.0 << " KB on disk after LZ\n";
+        }
+        
+        vector<double> undoNs;
+        undoNs.reserve(depth);
+        while (editor.undoDepth()) undoNs.push_back(timed([&] { editor.undo(); }));
+        bool atStart = editor.text() == document;
+        double redoMs = timed([&] { for (size_t i = 0; i < depth; i++) editor.redo(); }) / 1e6;
+        cout << "├── Undo all: " << percentiles(undoNs);
+        if (mode == 2) cout << " (" << history.spillReloads() << " blocks read back)";
+        cout << "\n";
+        cout << "└── Back at the loaded text: " << (atStart ? "✅" : "no (oldest history shed)") << ", redo all "
+             << redoMs << " ms, final text restored: " << (editor.text() == finalText ? "✅" : "⚠️") << "\n\n";
     }
+}
 
-    size_t calculateMemoryUsage() const {
-        size_t usage = currentText.length();
-        usage += undoStack.size() * 50;  // Approximate per action
-        usage += redoStack.size() * 50;
-        usage += operationHistory.size() * 30;
-        return usage;
+// Keystroke latency and append throughput with the journal attached, then
+// recovery time against journal length
+void runJournalBenchmark(size_t megabytes, int keystrokes) {
+    cout << "=== 📓 Edit Journal Benchmark (" << megabytes << " MB document, " << keystrokes << " keystrokes) ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    string document(megabytes << 20, ' ');
+    mt19937 textRng(42);
+    for (char& c : document) c = (textRng() % 6) ? (char)('a' + textRng() % 26) : ' ';
+    
+    auto typeSession = [&](TextEditor& editor, int count, vector<double>* keyNs) {
+        mt19937 rng(7);
+        const char keys[] = "the quick brown fox\njumps ";
+        size_t cursor = editor.length() / 2;
+        for (int i = 0; i < count; i++) {
+            if (rng() % 256 == 0) cursor = rng() % editor.length();
+            int r = rng() % 100;
+            auto key = [&] {
+                if (r < 12 && cursor > 0) editor.deleteRange(--cursor, 1);
+                else editor.insertAt(cursor++, string(1, keys[rng() % (sizeof(keys) - 1)]));
+            };
+            if (keyNs) keyNs->push_back(timed(key));
+            else key();
+        }
+    };
+    
+    string base = (filesystem::temp_directory_path() / "stack_text_editor_journal").string();
+    auto removeFiles = [&] {
+        error_code ignored;
+        filesystem::remove(base + ".journal", ignored);
+        filesystem::remove(base + ".snapshot", ignored);
+    };
+    
+    cout << "⌨️ Keystrokes (journal writes on a background thread):\n";
+    const int syncModes[] = {-1, 100, 0};
+    for (int syncMs : syncModes) {
+        removeFiles();
+        TextEditor editor(false);
+        if (syncMs >= 0 && !editor.openJournal(base, syncMs)) {
+            cout << "❌ Cannot open journal at " << base << "\n";
+            return;
+        }
+        editor.load(document);
+        vector<double> keyNs;
+        keyNs.reserve(keystrokes);
+        double typingMs = timed([&] { typeSession(editor, keystrokes, &keyNs); }) / 1e6;
+        double flushMs = timed([&] { editor.syncJournal(); }) / 1e6;
+        if (syncMs < 0) cout << "├── No journal:";
+        else cout << "├── fsync " << (syncMs ? "every " + to_string(syncMs) + " ms" : string("every batch")) << ":";
+        cout << " " << percentiles(keyNs) << "\n";
+        if (const EditJournal* journal = editor.editJournal()) {
+            cout << "│   " << keystrokes / typingMs * 1000 << " records/s appended, "
+                 << journal->bytesWritten() / 1048576.0 << " MB in " << journal->batchCount() << " batches, "
+                 << journal->syncCount() << " fsyncs, final sync " << flushMs << " ms\n";
+        }
     }
-};
+    
+    cout << "\n🔁 Recovery (snapshot of the loaded text + journal tail):\n";
+    for (int length = 10000; length <= keystrokes; length *= 10) {
+        for (size_t snapshotEvery : {(size_t)0, (size_t)1 << 20}) {
+            removeFiles();
+            string expected;
+            {
+                TextEditor editor(false);
+                editor.openJournal(base, 100, snapshotEvery);
+                editor.load(document);
+                typeSession(editor, length, nullptr);
+                expected = editor.text();
+            }
+            size_t journalBytes = filesystem::file_size(base + ".journal");
+            TextEditor recovered(false);
+            double recoverMs = timed([&] { recovered.openJournal(base); }) / 1e6;
+            cout << "├── " << setw(8) << length << " edits" << (snapshotEvery ? ", snapshot every 1 MB:" : ":                    ")
+                 << " journal " << setw(8) << journalBytes / 1048576.0 << " MB, recovered in " << setw(8) << recoverMs
+                 << " ms " << (recovered.text() == expected ? "✅" : "⚠️ mismatch") << "\n";
+        }
+    }
+    removeFiles();
 
-int main() {
+    cout << "\n📸 Snapshot hand-off on the editor thread:\n";
+    PieceTable pieces;
+    pieces.load(document);
+    mt19937 editRng(11);
+    for (int edits = 1000; edits <= keystrokes; edits *= 10) {
+        while ((int)pieces.pieceCount() < edits) pieces.insert(editRng() % (pieces.size() + 1), "x");
+        PieceTable::Spans spans;
+        string copy;
+        double spansMs = timed([&] { spans = pieces.spans(); }) / 1e6;
+        double copyMs = timed([&] { copy = pieces.str(); }) / 1e6;
+        cout << "├── " << setw(8) << pieces.pieceCount() << " pieces: spans " << setw(8) << spansMs
+             << " ms, copying the text " << setw(8) << copyMs << " ms\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--journal") {
+        long long megabytes = argc > 2 ? atoll(argv[2]) : 10;
+        int keystrokes = argc > 3 ? atoi(argv[3]) : 1000000;
+        runJournalBenchmark(megabytes > 0 ? megabytes : 10, keystrokes > 0 ? keystrokes : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--history") {
+        long long budgetKB = argc > 2 ? atoll(argv[2]) : 1024;
+        int keystrokes = argc > 3 ? atoi(argv[3]) : 1000000;
+        runHistoryBenchmark(budgetKB > 0 ? budgetKB : 1024, keystrokes > 0 ? keystrokes : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--keystrokes") {
+        long long megabytes = argc > 2 ? atoll(argv[2]) : 100;
+        int keystrokes = argc > 3 ? atoi(argv[3]) : 100000;
+        runKeystrokeBenchmark(megabytes > 0 ? megabytes : 100, keystrokes > 0 ? keystrokes : 100000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--pieces") {
+        long long megabytes = argc > 2 ? atoll(argv[2]) : 1024;
+        int edits = argc > 3 ? atoi(argv[3]) : 1000000;
+        runPieceTableBenchmark(megabytes > 0 ? megabytes : 1024, edits > 0 ? edits : 1000000);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        long long megabytes = argc > 2 ? atoll(argv[2]) : 100;
+        int edits = argc > 3 ? atoi(argv[3]) : 1000000;
+        runBenchmark(megabytes > 0 ? megabytes : 100, edits > 0 ? edits : 1000000);
+        return 0;
+    }
+    
     TextEditor editor;
     
     cout << "🚀 Starting Text Editor Demonstration:\n\n";
@@ -28,7 +28,7 @@ if %errorlevel% equ 0 (
 
 echo.
 echo 3. Compiling Recursion Algorithms...
-g++ -std=c++17 -O2 -o recursion_algorithms.exe recursion_algorithms.cpp
+g++ -std=c++17 -O2 -pthread -o recursion_algorithms.exe recursion_algorithms.cpp
 if %errorlevel% equ 0 (
     echo    ✅ recursion_algorithms.exe created successfully
 ) else (
@@ -37,7 +37,7 @@ if %errorlevel% equ 0 (
 
 echo.
 echo 4. Compiling Complete Algorithm Suite...
-g++ -std=c++17 -O2 -o complete_algorithms_suite.exe complete_algorithms_suite.cpp
+g++ -std=c++17 -O2 -pthread -o complete_algorithms_suite.exe complete_algorithms_suite.cpp
 if %errorlevel% equ 0 (
     echo    ✅ complete_algorithms_suite.exe created successfully
 ) else (
@@ -27,7 +27,7 @@ fi
 
 echo
 echo "3. Compiling Recursion Algorithms..."
-if g++ -std=c++17 -O2 -o recursion_algorithms recursion_algorithms.cpp; then
+if g++ -std=c++17 -O2 -pthread -o recursion_algorithms recursion_algorithms.cpp; then
     echo "    ✅ recursion_algorithms executable created successfully"
 else
     echo "    ❌ Error compiling recursion_algorithms.cpp"
@@ -35,7 +35,7 @@ fi
 
 echo
 echo "4. Compiling Complete Algorithm Suite..."
-if g++ -std=c++17 -O2 -o complete_algorithms_suite complete_algorithms_suite.cpp; then
+if g++ -std=c++17 -O2 -pthread -o complete_algorithms_suite complete_algorithms_suite.cpp; then
     echo "    ✅ complete_algorithms_suite executable created successfully"
 else
     echo "    ❌ Error compiling complete_algorithms_suite.cpp"
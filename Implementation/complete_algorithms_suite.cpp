@@ -18,6 +18,11 @@
 #include <chrono>
 #include <iomanip>
 #include <limits>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
 using namespace std;
 using namespace std::chrono;
 
@@ -193,6 +198,144 @@ struct Folder {
         : name(folderName), subFolders(subs), files(fileList) {}
 };
 
+// ⚡ Work-stealing parallel folder traversal
+//
+// Each worker walks its task depth-first with a private explicit stack. Every
+// `grain` folders it checks whether another worker is idle; if so it donates
+// the older half of its stack (the entries nearest the root, i.e. the largest
+// pending subtrees) to its shared deque. Idle workers steal from the front of
+// other deques. The split point therefore adapts to the tree: wide trees are
+// carved up early, while narrow or small ones stay on one worker with no task
+// overhead. visit(folder, depth, workerId) returns false to cancel the walk.
+class ParallelFolderWalker {
+public:
+    struct Task {
+        const Folder* folder;
+        int depth;
+    };
+    
+private:
+    struct alignas(64) Worker {
+        mutex lock;
+        deque<Task> shared; // donated work; owner pops the back, thieves take the front
+    };
+    
+    vector<unique_ptr<Worker>> workers;
+    atomic<long long> pending; // tasks queued or running
+    atomic<int> idleWorkers;
+    atomic<bool> cancelled;
+    int grain;
+    
+    bool takeTask(int id, Task& task) {
+        int n = (int)workers.size();
+        {
+            Worker& own = *workers[id];
+            lock_guard<mutex> guard(own.lock);
+            if (!own.shared.empty()) {
+                task = own.shared.back();
+                own.shared.pop_back();
+                return true;
+            }
+        }
+        for (int k = 1; k < n; k++) {
+            Worker& victim = *workers[(id + k) % n];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.shared.empty()) {
+                task = victim.shared.front();
+                victim.shared.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    template <typename Visit>
+    void runTask(int id, Task task, Visit& visit) {
+        vector<Task> stack{task};
+        int sinceCheck = 0;
+        while (!stack.empty()) {
+            if (cancelled.load(memory_order_relaxed)) return;
+            Task current = stack.back();
+            stack.pop_back();
+            if (!visit(*current.folder, current.depth, id)) {
+                cancelled.store(true, memory_order_relaxed);
+                return;
+            }
+            const vector<Folder>& subs = current.folder->subFolders;
+            for (size_t i = subs.size(); i-- > 0;) stack.push_back({&subs[i], current.depth + 1});
+            
+            if (++sinceCheck >= grain && stack.size() > 1 && idleWorkers.load(memory_order_relaxed) > 0) {
+                sinceCheck = 0;
+                size_t give = stack.size() / 2;
+                pending.fetch_add((long long)give);
+                {
+                    Worker& own = *workers[id];
+                    lock_guard<mutex> guard(own.lock);
+                    own.shared.insert(own.shared.end(), stack.begin(), stack.begin() + give);
+                }
+                stack.erase(stack.begin(), stack.begin() + give);
+            }
+        }
+    }
+    
+    template <typename Visit>
+    void workerLoop(int id, Visit& visit) {
+        bool idle = false;
+        while (!cancelled.load(memory_order_relaxed)) {
+            Task task;
+            if (takeTask(id, task)) {
+                if (idle) {
+                    idleWorkers.fetch_sub(1);
+                    idle = false;
+                }
+                runTask(id, task, visit);
+                pending.fetch_sub(1);
+                continue;
+            }
+            if (pending.load() == 0) break;
+            if (!idle) {
+                idleWorkers.fetch_add(1);
+                idle = true;
+            }
+            this_thread::yield();
+        }
+        if (idle) idleWorkers.fetch_sub(1);
+    }
+    
+public:
+    ParallelFolderWalker(int threads, int grainSize = 256)
+        : pending(0), idleWorkers(0), cancelled(false), grain(max(1, grainSize)) {
+        for (int i = 0; i < max(1, threads); i++) workers.push_back(make_unique<Worker>());
+    }
+    
+    int threadCount() const { return (int)workers.size(); }
+    
+    // Returns false if the walk was cancelled by the visitor
+    template <typename Visit>
+    bool run(const Folder& root, Visit visit) {
+        pending.store(1);
+        idleWorkers.store(0);
+        cancelled.store(false);
+        workers[0]->shared.push_back({&root, 0});
+        
+        vector<thread> threads;
+        for (int id = 1; id < threadCount(); id++) {
+            threads.emplace_back([this, id, &visit] { workerLoop(id, visit); });
+        }
+        workerLoop(0, visit);
+        for (thread& t : threads) t.join();
+        for (auto& worker : workers) worker->shared.clear();
+        return !cancelled.load();
+    }
+};
+
+// Aggregates gathered by the parallel walk
+struct FolderStats {
+    long long folders = 0;
+    long long files = 0;
+    int maxDepth = 0;
+};
+
 class FileSystemExplorer {
 private:
     int folderCount = 0;
@@ -236,6 +379,44 @@ public:
         return size;
     }
     
+    // Parallel calculateSize on a work-stealing pool; also gathers counts and depth
+    FolderStats calculateStatsParallel(const Folder& root, int threads, int grain = 256) {
+        ParallelFolderWalker walker(threads, grain);
+        struct alignas(64) Partial {
+            FolderStats stats;
+        };
+        vector<Partial> partials(walker.threadCount());
+        walker.run(root, [&](const Folder& f, int depth, int id) {
+            FolderStats& local = partials[id].stats;
+            local.folders++;
+            local.files += f.files.size();
+            if (depth > local.maxDepth) local.maxDepth = depth;
+            return true;
+        });
+        FolderStats total;
+        for (const Partial& p : partials) {
+            total.folders += p.stats.folders;
+            total.files += p.stats.files;
+            total.maxDepth = max(total.maxDepth, p.stats.maxDepth);
+        }
+        return total;
+    }
+    
+    // Parallel search; the first match cancels the remaining workers
+    bool findFolderParallel(const Folder& root, const string& target, int threads) {
+        ParallelFolderWalker walker(threads);
+        atomic<int> foundDepth(-1);
+        walker.run(root, [&](const Folder& f, int depth, int) {
+            if (f.name != target) return true;
+            int expected = -1;
+            foundDepth.compare_exchange_strong(expected, depth);
+            return false;
+        });
+        if (foundDepth.load() < 0) return false;
+        cout << "🎯 Found '" << target << "' at depth " << foundDepth.load() << " (parallel)" << endl;
+        return true;
+    }
+    
     // Recursive search
     bool findFolder(const Folder& f, const string& target, int depth = 0) {
         if (f.name == target) {
@@ -458,6 +639,13 @@ void runRecursionDemo() {
         cout << "❌ Folder not found\n";
     }
     
+    int threads = (int)max(2u, thread::hardware_concurrency());
+    cout << "\n⚡ Parallel Aggregation (" << threads << " work-stealing threads):\n";
+    FolderStats stats = explorer.calculateStatsParallel(myComputer, threads);
+    cout << "├── Items: " << stats.folders + stats.files << " (recursive: " << explorer.calculateSize(myComputer) << ")\n";
+    cout << "└── Folders: " << stats.folders << ", Files: " << stats.files << ", Max depth: " << stats.maxDepth << "\n";
+    explorer.findFolderParallel(myComputer, "Family", threads);
+    
     cout << "\n🧩 Recursion Concepts:\n";
     cout << "• Base case: Folder with no subfolders\n";
     cout << "• Recursive case: Process current folder, then recurse on subfolders\n";
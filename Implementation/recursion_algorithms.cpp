@@ -6,12 +6,49 @@
  * 
  * Time Complexity: O(n) where n is total number of folders
  * Space Complexity: O(d) where d is maximum depth of folder structure
+ * 
+ * Each recursive function has an iterative twin driven by FolderWalker, an
+ * explicit-stack pre-order iterator, for hierarchies deep enough to overflow
+ * the call stack. Run with --stress [depth] for a deep-chain stress test and
+ * a recursive vs iterative throughput comparison.
+ * 
+ * ParallelFolderWalker spreads aggregation and search over a work-stealing
+ * thread pool; --parallel [threads] prints speedup curves.
+ * --scan <path> [threads] builds the Folder tree from a real directory.
+ * FlatFolderTree stores the hierarchy as index-linked nodes over a shared name
+ * arena; --flat [entries] compares it with nested Folders on a large tree.
+ * FolderPathIndex answers full-path queries in O(depth) via a name hash and
+ * parent indices; --paths [folders] [queries] benchmarks it against DFS.
  */
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <system_error>
+#include <string_view>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 using namespace std;
 using namespace std::chrono;
 
@@ -21,10 +58,224 @@ struct Folder {
     vector<string> files;
     
     // Constructor for easier folder creation
-    Folder(string folderName) : name(folderName) {}
-    Folder(string folderName, vector<Folder> subs) : name(folderName), subFolders(subs) {}
+    // Arguments are taken by value and moved in, which avoids copies for
+    // temporaries and std::move'd vectors. Nested brace initialisation still
+    // deep-copies each subtree at every enclosing level (initializer_list
+    // elements are const), which is fine for the small sample tree; large
+    // trees are built with push_back/std::move instead.
+    Folder(string folderName) : name(std::move(folderName)) {}
+    Folder(string folderName, vector<Folder> subs) : name(std::move(folderName)), subFolders(std::move(subs)) {}
     Folder(string folderName, vector<Folder> subs, vector<string> fileList) 
-        : name(folderName), subFolders(subs), files(fileList) {}
+        : name(std::move(folderName)), subFolders(std::move(subs)), files(std::move(fileList)) {}
+    
+    Folder(const Folder&) = default;
+    Folder(Folder&&) = default;
+    Folder& operator=(const Folder&) = default;
+    Folder& operator=(Folder&&) = default;
+    
+    // Tear down nested folders with an explicit worklist: the implicit
+    // destructor would recurse once per nesting level.
+    ~Folder() {
+        vector<Folder> pending = std::move(subFolders);
+        while (!pending.empty()) {
+            Folder last = std::move(pending.back());
+            pending.pop_back();
+            for (Folder& sub : last.subFolders) pending.push_back(std::move(sub));
+            last.subFolders.clear();
+        }
+    }
+};
+
+// One step of a pre-order walk: the folder, its depth, and whether it is the
+// last child of its parent (needed to draw tree connectors).
+struct FolderVisit {
+    const Folder* folder;
+    int depth;
+    bool isLast;
+};
+
+// 🧭 Generic pre-order iterator over a folder hierarchy.
+// Keeps the current root-to-folder path on an explicit stack (one entry per
+// level, holding each folder's index among its siblings) instead of using the
+// call stack, so depth is limited only by heap memory.
+// Usage: for (const FolderVisit& v : FolderWalker(root)) ...
+class FolderWalker {
+    const Folder* root;
+
+public:
+    class iterator {
+        struct PathEntry {
+            const Folder* folder;
+            size_t indexInParent;
+            size_t siblingCount;
+        };
+        vector<PathEntry> path;
+        FolderVisit visit;
+        
+        void refreshVisit() {
+            if (path.empty()) return;
+            const PathEntry& top = path.back();
+            visit = {top.folder, (int)path.size() - 1, top.indexInParent + 1 == top.siblingCount};
+        }
+
+    public:
+        using iterator_category = input_iterator_tag;
+        using value_type = FolderVisit;
+        using difference_type = ptrdiff_t;
+        using pointer = const FolderVisit*;
+        using reference = const FolderVisit&;
+        
+        iterator() : visit{nullptr, 0, true} {}
+        explicit iterator(const Folder* start) : visit{nullptr, 0, true} {
+            if (start) path.push_back({start, 0, 1});
+            refreshVisit();
+        }
+        
+        reference operator*() const { return visit; }
+        pointer operator->() const { return &visit; }
+        
+        iterator& operator++() {
+            const vector<Folder>& subs = path.back().folder->subFolders;
+            if (subs.empty()) {
+                skipChildren();
+                return *this;
+            }
+            path.push_back({&subs[0], 0, subs.size()});
+            refreshVisit();
+            return *this;
+        }
+        
+        // Advance to the next folder that is not below the current one
+        void skipChildren() {
+            while (!path.empty()) {
+                PathEntry& top = path.back();
+                if (top.indexInParent + 1 < top.siblingCount) {
+                    top.folder++; // siblings are contiguous in the parent's vector
+                    top.indexInParent++;
+                    break;
+                }
+                path.pop_back();
+            }
+            refreshVisit();
+        }
+        
+        bool operator==(const iterator& other) const { return path.empty() && other.path.empty(); }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    };
+    
+    explicit FolderWalker(const Folder& start) : root(&start) {}
+    iterator begin() const { return iterator(root); }
+    iterator end() const { return iterator(); }
+};
+
+// 🗜️ FlatFolderTree: the same hierarchy in three contiguous arrays.
+// Folders live in one node array linked by parent / first-child / next-sibling
+// indices; each folder's files are a contiguous run in a second array; every
+// name is a (offset, length) slice of one shared character arena. Building
+// costs a handful of amortised vector appends instead of one heap block per
+// folder, file list and long name, and nothing is ever deep-copied.
+// Nodes are appended in the order they are added, so a pre-order build keeps
+// every subtree contiguous.
+class FlatFolderTree {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    
+    struct NameRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+    
+    struct Node {
+        NameRef name;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint32_t nextSibling;
+        uint32_t firstFile; // index into the file array
+        uint32_t fileCount;
+    };
+    
+private:
+    vector<Node> nodes;
+    vector<NameRef> fileNames;
+    string arena;
+    vector<uint32_t> lastChild; // build-time only: O(1) append to a child list
+    
+    NameRef storeName(string_view text) {
+        if (arena.size() + text.size() > UINT32_MAX) throw length_error("FlatFolderTree name arena is full");
+        NameRef ref{(uint32_t)arena.size(), (uint32_t)text.size()};
+        arena.append(text);
+        return ref;
+    }
+    
+public:
+    FlatFolderTree() = default;
+    
+    // Converts a nested Folder (pre-order, via FolderWalker so depth is unbounded)
+    explicit FlatFolderTree(const Folder& root) {
+        vector<uint32_t> idAtDepth;
+        for (const FolderVisit& visit : FolderWalker(root)) {
+            idAtDepth.resize(visit.depth);
+            uint32_t id = addFolder(visit.depth == 0 ? NONE : idAtDepth.back(), visit.folder->name);
+            for (const string& file : visit.folder->files) addFile(file);
+            idAtDepth.push_back(id);
+        }
+        shrinkToFit();
+    }
+    
+    void reserve(size_t folders, size_t files, size_t nameBytes) {
+        nodes.reserve(folders);
+        lastChild.reserve(folders);
+        fileNames.reserve(files);
+        arena.reserve(nameBytes);
+    }
+    
+    // Appends a folder as the last child of parent (NONE for the root) and returns its id.
+    // Works after shrinkToFit too: the last-child table is rebuilt once on demand.
+    uint32_t addFolder(uint32_t parent, string_view name) {
+        if (lastChild.size() < nodes.size()) {
+            lastChild.assign(nodes.size(), NONE);
+            for (uint32_t i = 1; i < nodes.size(); i++) if (nodes[i].parent != NONE) lastChild[nodes[i].parent] = i;
+        }
+        uint32_t id = (uint32_t)nodes.size();
+        nodes.push_back({storeName(name), parent, NONE, NONE, (uint32_t)fileNames.size(), 0});
+        lastChild.push_back(NONE);
+        if (parent != NONE) {
+            if (lastChild[parent] == NONE) nodes[parent].firstChild = id;
+            else nodes[lastChild[parent]].nextSibling = id;
+            lastChild[parent] = id;
+        }
+        return id;
+    }
+    
+    // Adds a file to the most recently added folder (keeps each file list contiguous)
+    void addFile(string_view name) {
+        if (nodes.empty()) throw logic_error("FlatFolderTree::addFile needs a folder to add to");
+        fileNames.push_back(storeName(name));
+        nodes.back().fileCount++;
+    }
+    
+    // Drops build-time bookkeeping and spare capacity once the tree is complete
+    void shrinkToFit() {
+        vector<uint32_t>().swap(lastChild);
+        nodes.shrink_to_fit();
+        fileNames.shrink_to_fit();
+        arena.shrink_to_fit();
+    }
+    
+    uint32_t root() const { return 0; }
+    bool empty() const { return nodes.empty(); }
+    size_t folderCount() const { return nodes.size(); }
+    size_t fileCount() const { return fileNames.size(); }
+    const Node& node(uint32_t id) const { return nodes[id]; }
+    
+    string_view name(NameRef ref) const { return string_view(arena.data() + ref.offset, ref.length); }
+    string_view folderName(uint32_t id) const { return name(nodes[id].name); }
+    string_view fileName(uint32_t folder, uint32_t i) const { return name(fileNames[nodes[folder].firstFile + i]); }
+    
+    size_t memoryBytes() const {
+        return nodes.capacity() * sizeof(Node) + fileNames.capacity() * sizeof(NameRef) +
+               arena.capacity() + lastChild.capacity() * sizeof(uint32_t);
+    }
 };
 
 // Global counters for analysis
@@ -88,24 +339,1062 @@ bool findFolder(const Folder& f, const string& target, int depth = 0) {
     return false;
 }
 
-// Create folder path string recursively
-void getFolderPath(const Folder& f, const string& target, string currentPath = "", bool& found = *(new bool(false))) {
-    string fullPath = currentPath.empty() ? f.name : currentPath + "/" + f.name;
+// Iterative twin of displayFolders (same output, no recursion)
+void displayFoldersIterative(const Folder& root) {
+    vector<bool> lastAtDepth; // isLast of each ancestor, for the prefix
+    for (const FolderVisit& visit : FolderWalker(root)) {
+        const Folder& f = *visit.folder;
+        folderCount++;
+        if (visit.depth > maxDepth) maxDepth = visit.depth;
+        
+        lastAtDepth.resize(visit.depth);
+        string prefix;
+        for (bool ancestorLast : lastAtDepth) prefix += ancestorLast ? "    " : "│   ";
+        cout << prefix << (visit.isLast ? "└── " : "├── ") << "📁 " << f.name << endl;
+        lastAtDepth.push_back(visit.isLast);
+        
+        string newPrefix = prefix + (visit.isLast ? "    " : "│   ");
+        for (size_t i = 0; i < f.files.size(); i++) {
+            fileCount++;
+            string fileConnector = (i == f.files.size() - 1 && f.subFolders.empty()) ? "└── " : "├── ";
+            cout << newPrefix << fileConnector << "📄 " << f.files[i] << endl;
+        }
+    }
+}
+
+// Iterative twin of calculateSize
+long long calculateSizeIterative(const Folder& root) {
+    long long size = 0;
+    for (const FolderVisit& visit : FolderWalker(root)) {
+        size += 1 + visit.folder->files.size();
+    }
+    return size;
+}
+
+// Iterative twin of findFolder (same pre-order, so the same match wins)
+bool findFolderIterative(const Folder& root, const string& target) {
+    for (const FolderVisit& visit : FolderWalker(root)) {
+        if (visit.folder->name == target) {
+            cout << "🎯 Found '" << target << "' at depth " << visit.depth << endl;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ⚡ Work-stealing parallel folder traversal
+//
+// Each worker walks its task depth-first with a private explicit stack. Every
+// `grain` folders it checks whether another worker is idle; if so it donates
+// the older half of its stack (the entries nearest the root, i.e. the largest
+// pending subtrees) to its shared deque. Idle workers steal from the front of
+// other deques. The split point therefore adapts to the tree: wide trees are
+// carved up early, while narrow or small ones stay on one worker with no task
+// overhead. visit(folder, depth, workerId) returns false to cancel the walk.
+class ParallelFolderWalker {
+public:
+    struct Task {
+        const Folder* folder;
+        int depth;
+    };
     
-    if (f.name == target) {
-        cout << "📍 Full path: " << fullPath << endl;
-        found = true;
+private:
+    struct alignas(64) Worker {
+        mutex lock;
+        deque<Task> shared; // donated work; owner pops the back, thieves take the front
+    };
+    
+    vector<unique_ptr<Worker>> workers;
+    atomic<long long> pending; // tasks queued or running
+    atomic<int> idleWorkers;
+    atomic<bool> cancelled;
+    int grain;
+    
+    bool takeTask(int id, Task& task) {
+        int n = (int)workers.size();
+        {
+            Worker& own = *workers[id];
+            lock_guard<mutex> guard(own.lock);
+            if (!own.shared.empty()) {
+                task = own.shared.back();
+                own.shared.pop_back();
+                return true;
+            }
+        }
+        for (int k = 1; k < n; k++) {
+            Worker& victim = *workers[(id + k) % n];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.shared.empty()) {
+                task = victim.shared.front();
+                victim.shared.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    template <typename Visit>
+    void runTask(int id, Task task, Visit& visit) {
+        vector<Task> stack{task};
+        int sinceCheck = 0;
+        while (!stack.empty()) {
+            if (cancelled.load(memory_order_relaxed)) return;
+            Task current = stack.back();
+            stack.pop_back();
+            if (!visit(*current.folder, current.depth, id)) {
+                cancelled.store(true, memory_order_relaxed);
+                return;
+            }
+            const vector<Folder>& subs = current.folder->subFolders;
+            for (size_t i = subs.size(); i-- > 0;) stack.push_back({&subs[i], current.depth + 1});
+            
+            if (++sinceCheck >= grain && stack.size() > 1 && idleWorkers.load(memory_order_relaxed) > 0) {
+                sinceCheck = 0;
+                size_t give = stack.size() / 2;
+                pending.fetch_add((long long)give);
+                {
+                    Worker& own = *workers[id];
+                    lock_guard<mutex> guard(own.lock);
+                    own.shared.insert(own.shared.end(), stack.begin(), stack.begin() + give);
+                }
+                stack.erase(stack.begin(), stack.begin() + give);
+            }
+        }
+    }
+    
+    template <typename Visit>
+    void workerLoop(int id, Visit& visit) {
+        bool idle = false;
+        while (!cancelled.load(memory_order_relaxed)) {
+            Task task;
+            if (takeTask(id, task)) {
+                if (idle) {
+                    idleWorkers.fetch_sub(1);
+                    idle = false;
+                }
+                runTask(id, task, visit);
+                pending.fetch_sub(1);
+                continue;
+            }
+            if (pending.load() == 0) break;
+            if (!idle) {
+                idleWorkers.fetch_add(1);
+                idle = true;
+            }
+            this_thread::yield();
+        }
+        if (idle) idleWorkers.fetch_sub(1);
+    }
+    
+public:
+    ParallelFolderWalker(int threads, int grainSize = 256)
+        : pending(0), idleWorkers(0), cancelled(false), grain(max(1, grainSize)) {
+        for (int i = 0; i < max(1, threads); i++) workers.push_back(make_unique<Worker>());
+    }
+    
+    int threadCount() const { return (int)workers.size(); }
+    
+    // Returns false if the walk was cancelled by the visitor
+    template <typename Visit>
+    bool run(const Folder& root, Visit visit) {
+        pending.store(1);
+        idleWorkers.store(0);
+        cancelled.store(false);
+        workers[0]->shared.push_back({&root, 0});
+        
+        vector<thread> threads;
+        for (int id = 1; id < threadCount(); id++) {
+            threads.emplace_back([this, id, &visit] { workerLoop(id, visit); });
+        }
+        workerLoop(0, visit);
+        for (thread& t : threads) t.join();
+        for (auto& worker : workers) worker->shared.clear();
+        return !cancelled.load();
+    }
+};
+
+// Aggregates gathered by the parallel walk
+struct FolderStats {
+    long long folders = 0;
+    long long files = 0;
+    int maxDepth = 0;
+};
+
+// Parallel version of calculateSize that also reports counts and depth
+FolderStats calculateStatsParallel(const Folder& root, int threads, int grain = 256) {
+    ParallelFolderWalker walker(threads, grain);
+    struct alignas(64) Partial {
+        FolderStats stats;
+    };
+    vector<Partial> partials(walker.threadCount());
+    walker.run(root, [&](const Folder& f, int depth, int id) {
+        FolderStats& local = partials[id].stats;
+        local.folders++;
+        local.files += f.files.size();
+        if (depth > local.maxDepth) local.maxDepth = depth;
+        return true;
+    });
+    FolderStats total;
+    for (const Partial& p : partials) {
+        total.folders += p.stats.folders;
+        total.files += p.stats.files;
+        total.maxDepth = max(total.maxDepth, p.stats.maxDepth);
+    }
+    return total;
+}
+
+// Parallel findFolder: the first worker to match cancels everyone else.
+// With several matches, any one of them may be reported.
+const Folder* findFolderParallel(const Folder& root, const string& target, int threads,
+                                 int& foundDepth, long long* visited = nullptr, int grain = 256) {
+    ParallelFolderWalker walker(threads, grain);
+    atomic<const Folder*> match(nullptr);
+    atomic<int> matchDepth(-1);
+    atomic<long long> seen(0);
+    walker.run(root, [&](const Folder& f, int depth, int) {
+        if (visited) seen.fetch_add(1, memory_order_relaxed);
+        if (f.name != target) return true;
+        const Folder* expected = nullptr;
+        if (match.compare_exchange_strong(expected, &f)) matchDepth.store(depth);
+        return false;
+    });
+    if (visited) *visited = seen.load();
+    foundDepth = matchDepth.load();
+    return match.load();
+}
+
+// 🛰️ DirectoryCrawler: parallel scanner for a real directory tree
+//
+// Every directory is one task on a shared queue served by a worker pool; a
+// task's subdirectories are queued in one batch when it finishes. On Linux a
+// task opens its directory once, reads entries in 64 KB batches with
+// getdents64 and stats files relative to the directory fd with statx, asking
+// only for type and size and not forcing a sync with remote filesystems.
+// Symlinks are listed as files and never followed. Other platforms fall back
+// to std::filesystem::directory_iterator per directory.
+class DirectoryCrawler {
+public:
+    struct Directory {
+        int id;
+        int parent;     // -1 for the root
+        string name;    // last path component (the root keeps the path as given)
+        vector<string> files;
+        vector<unsigned long long> fileSizes; // bytes, 0 when sizes are not collected
+        vector<int> subdirectories;           // ids, always greater than this id
+    };
+    
+    struct Stats {
+        long long directories = 0;
+        long long files = 0;
+        unsigned long long bytes = 0;
+        long long errors = 0; // directories that could not be opened
+        double seconds = 0;
+    };
+    
+private:
+    struct Task {
+        string path;
+        Directory* directory;
+    };
+    
+    struct Entry {
+        string name;
+        bool isDirectory;
+        unsigned long long size;
+    };
+    
+    vector<unique_ptr<Directory>> directoryList;
+    mutex registryLock;
+    mutex queueLock;
+    condition_variable queueReady;
+    deque<Task> queue;
+    int activeTasks = 0;
+    bool collectSizes;
+    bool rootUnreadable = false;
+    atomic<long long> errorCount{0};
+    double elapsed = 0;
+    
+    bool listDirectory(const string& path, vector<Entry>& out) {
+#ifdef __linux__
+        struct LinuxDirent64 {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+        int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return false;
+        thread_local vector<char> buffer(64 * 1024);
+        while (true) {
+            long bytes = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if (bytes == 0) break;
+            if (bytes < 0) { // a read error, not the end: report it rather than a short listing
+                close(fd);
+                return false;
+            }
+            for (long offset = 0; offset < bytes;) {
+                const LinuxDirent64* entry = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+                offset += entry->d_reclen;
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) continue;
+                
+                unsigned char type = entry->d_type;
+                unsigned long long size = 0;
+                if (type == DT_UNKNOWN || (collectSizes && type == DT_REG)) {
+                    struct statx info;
+                    if (statx(fd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC,
+                              STATX_TYPE | STATX_SIZE, &info) == 0) {
+                        if (S_ISDIR(info.stx_mode)) type = DT_DIR;
+                        else if (S_ISREG(info.stx_mode)) type = DT_REG;
+                        if (type == DT_REG) size = info.stx_size;
+                    }
+                }
+                out.push_back({name, type == DT_DIR, size});
+            }
+        }
+        close(fd);
+        return true;
+#else
+        error_code ec;
+        filesystem::directory_iterator it(path, filesystem::directory_options::skip_permission_denied, ec);
+        if (ec) return false;
+        for (const auto& entry : it) {
+            bool isDirectory = entry.is_directory(ec) && !entry.is_symlink(ec);
+            unsigned long long size = 0;
+            if (collectSizes && !isDirectory && entry.is_regular_file(ec)) size = entry.file_size(ec);
+            out.push_back({entry.path().filename().string(), isDirectory, size});
+        }
+        return true;
+#endif
+    }
+    
+    void scan(const Task& task, vector<Task>& subtasks) {
+        vector<Entry> entries;
+        if (!listDirectory(task.path, entries)) {
+            errorCount.fetch_add(1, memory_order_relaxed);
+            if (task.directory->id == 0) rootUnreadable = true;
+            return;
+        }
+        Directory& dir = *task.directory;
+        vector<string> subdirectoryNames;
+        for (Entry& entry : entries) {
+            if (entry.isDirectory) {
+                subdirectoryNames.push_back(std::move(entry.name));
+            } else {
+                dir.files.push_back(std::move(entry.name));
+                dir.fileSizes.push_back(entry.size);
+            }
+        }
+        if (subdirectoryNames.empty()) return;
+        
+        string prefix = task.path.back() == '/' ? task.path : task.path + "/";
+        lock_guard<mutex> guard(registryLock);
+        for (string& name : subdirectoryNames) {
+            directoryList.push_back(make_unique<Directory>());
+            Directory* child = directoryList.back().get();
+            child->id = (int)directoryList.size() - 1;
+            child->parent = dir.id;
+            dir.subdirectories.push_back(child->id);
+            subtasks.push_back({prefix + name, child});
+            child->name = std::move(name);
+        }
+    }
+    
+    void workerLoop() {
+        unique_lock<mutex> lock(queueLock);
+        while (true) {
+            queueReady.wait(lock, [this] { return !queue.empty() || activeTasks == 0; });
+            if (queue.empty()) break; // nothing queued and nothing running: done
+            
+            Task task = std::move(queue.front());
+            queue.pop_front();
+            activeTasks++;
+            lock.unlock();
+            
+            vector<Task> subtasks;
+            scan(task, subtasks);
+            
+            lock.lock();
+            activeTasks--;
+            for (Task& sub : subtasks) queue.push_back(std::move(sub));
+            if (!subtasks.empty() || activeTasks == 0) queueReady.notify_all();
+        }
+    }
+    
+public:
+    explicit DirectoryCrawler(bool withSizes = true) : collectSizes(withSizes) {}
+    
+    // Scans everything below rootPath; returns false if the root itself cannot be read
+    bool crawl(const string& rootPath, int threads) {
+        auto start = high_resolution_clock::now();
+        directoryList.clear();
+        directoryList.push_back(make_unique<Directory>());
+        directoryList[0]->id = 0;
+        directoryList[0]->parent = -1;
+        directoryList[0]->name = rootPath;
+        errorCount.store(0);
+        rootUnreadable = false;
+        queue.push_back({rootPath, directoryList[0].get()});
+        activeTasks = 0;
+        
+        vector<thread> pool;
+        for (int i = 1; i < max(1, threads); i++) pool.emplace_back([this] { workerLoop(); });
+        workerLoop();
+        for (thread& t : pool) t.join();
+        
+        elapsed = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+        return !rootUnreadable;
+    }
+    
+    const vector<unique_ptr<Directory>>& directories() const { return directoryList; }
+    
+    Stats stats() const {
+        Stats s;
+        s.directories = (long long)directoryList.size();
+        for (const auto& dir : directoryList) {
+            s.files += (long long)dir->files.size();
+            for (unsigned long long size : dir->fileSizes) s.bytes += size;
+        }
+        s.errors = errorCount.load();
+        s.seconds = elapsed;
+        return s;
+    }
+};
+
+// Naive baseline: std::filesystem::recursive_directory_iterator plus file_size per file
+DirectoryCrawler::Stats crawlWithStdFilesystem(const string& rootPath) {
+    auto start = high_resolution_clock::now();
+    DirectoryCrawler::Stats s;
+    s.directories = 1;
+    error_code ec;
+    filesystem::recursive_directory_iterator it(rootPath, filesystem::directory_options::skip_permission_denied, ec), end;
+    if (ec) s.errors++;
+    for (; !ec && it != end; it.increment(ec)) {
+        const filesystem::directory_entry& entry = *it;
+        error_code entryError;
+        filesystem::file_status status = entry.symlink_status(entryError);
+        if (filesystem::is_directory(status)) {
+            s.directories++;
+        } else {
+            s.files++;
+            if (filesystem::is_regular_file(status)) s.bytes += entry.file_size(entryError);
+        }
+    }
+    if (ec) s.errors++;
+    s.seconds = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1e6;
+    return s;
+}
+
+// Converts a crawl into the Folder structure used throughout this file.
+// Children always have larger ids than their parent, so assembling in
+// descending id order finishes every child before its parent needs it.
+Folder buildFolderFromCrawl(const DirectoryCrawler& crawler) {
+    const auto& dirs = crawler.directories();
+    vector<Folder> built;
+    built.reserve(dirs.size());
+    for (size_t i = 0; i < dirs.size(); i++) built.emplace_back(dirs[i]->name);
+    for (size_t i = dirs.size(); i-- > 0;) {
+        const DirectoryCrawler::Directory& dir = *dirs[i];
+        Folder& folder = built[i];
+        folder.files = dir.files;
+        sort(folder.files.begin(), folder.files.end());
+        for (int child : dir.subdirectories) folder.subFolders.push_back(std::move(built[child]));
+        sort(folder.subFolders.begin(), folder.subFolders.end(),
+             [](const Folder& a, const Folder& b) { return a.name < b.name; });
+    }
+    return std::move(built[0]);
+}
+
+// Crawls a real path, builds a Folder tree from it and compares with std::filesystem
+void runDirectoryScan(const string& path, int threads) {
+    cout << "=== 🛰️ Directory Scan: " << path << " (" << threads << " threads) ===\n\n";
+    
+    DirectoryCrawler crawler(true);
+    if (!crawler.crawl(path, threads)) {
+        cout << "❌ Cannot open '" << path << "'\n";
         return;
     }
+    DirectoryCrawler::Stats fast = crawler.stats();
+    
+    auto start = high_resolution_clock::now();
+    Folder root = buildFolderFromCrawl(crawler);
+    double buildMs = duration_cast<microseconds>(high_resolution_clock::now() - start).count() / 1000.0;
+    
+    DirectoryCrawler::Stats naive = crawlWithStdFilesystem(path);
+    
+    auto report = [](const string& label, const DirectoryCrawler::Stats& s) {
+        double seconds = max(s.seconds, 1e-9);
+        cout << "📊 " << left << setw(34) << label << right << fixed << setprecision(1)
+             << setw(9) << s.seconds * 1000 << " ms | " << setw(10) << (s.files + s.directories) / seconds
+             << " entries/s | " << s.files << " files, " << s.directories << " dirs, "
+             << s.bytes / (1024 * 1024) << " MB" << (s.errors ? " (" + to_string(s.errors) + " unreadable)" : string()) << "\n";
+    };
+    report("getdents64 + statx crawler", fast);
+    report("recursive_directory_iterator", naive);
+    cout << "⚡ Speedup: " << setprecision(2) << naive.seconds / max(fast.seconds, 1e-9) << "x\n";
+    
+    FolderStats stats = calculateStatsParallel(root, threads);
+    cout << "\n🌳 Folder tree built in " << setprecision(1) << buildMs << " ms: "
+         << stats.folders << " folders, " << stats.files << " files, max depth " << stats.maxDepth << "\n";
+    if (stats.folders <= 40) {
+        folderCount = fileCount = maxDepth = 0;
+        displayFoldersIterative(root);
+    }
+}
+
+// Build the path to a folder recursively. One buffer is shared by the whole
+// search: each level appends its name and truncates it again on the way back.
+bool findFolderPath(const Folder& f, const string& target, string& path) {
+    size_t mark = path.size();
+    if (!path.empty()) path += '/';
+    path += f.name;
+    
+    if (f.name == target) return true;
     
     for (const auto& sub : f.subFolders) {
-        if (!found) {
-            getFolderPath(sub, target, fullPath, found);
+        if (findFolderPath(sub, target, path)) return true;
+    }
+    path.resize(mark);
+    return false;
+}
+
+// Create folder path string recursively
+bool getFolderPath(const Folder& f, const string& target) {
+    string path;
+    if (!findFolderPath(f, target, path)) return false;
+    cout << "📍 Full path: " << path << endl;
+    return true;
+}
+
+// 🗜️ The same recursive algorithms over a FlatFolderTree: children are
+// reached through firstChild / nextSibling indices instead of nested vectors
+
+void displayFolders(const FlatFolderTree& tree, uint32_t id = 0, int depth = 0, bool isLast = true, string prefix = "") {
+    const FlatFolderTree::Node& f = tree.node(id);
+    folderCount++;
+    if (depth > maxDepth) maxDepth = depth;
+    
+    string connector = isLast ? "└── " : "├── ";
+    cout << prefix << connector << "📁 " << tree.folderName(id) << endl;
+    
+    string newPrefix = prefix + (isLast ? "    " : "│   ");
+    for (uint32_t i = 0; i < f.fileCount; i++) {
+        fileCount++;
+        string fileConnector = (i == f.fileCount - 1 && f.firstChild == FlatFolderTree::NONE) ? "└── " : "├── ";
+        cout << newPrefix << fileConnector << "📄 " << tree.fileName(id, i) << endl;
+    }
+    
+    for (uint32_t child = f.firstChild; child != FlatFolderTree::NONE; child = tree.node(child).nextSibling) {
+        bool isLastFolder = tree.node(child).nextSibling == FlatFolderTree::NONE;
+        displayFolders(tree, child, depth + 1, isLastFolder, newPrefix);
+    }
+}
+
+long long calculateSize(const FlatFolderTree& tree, uint32_t id = 0) {
+    const FlatFolderTree::Node& f = tree.node(id);
+    long long size = 1 + f.fileCount;
+    for (uint32_t child = f.firstChild; child != FlatFolderTree::NONE; child = tree.node(child).nextSibling) {
+        size += calculateSize(tree, child);
+    }
+    return size;
+}
+
+// Returns the id of the first match in pre-order, or NONE
+uint32_t findFolder(const FlatFolderTree& tree, string_view target, uint32_t id = 0, int depth = 0) {
+    if (tree.folderName(id) == target) {
+        cout << "🎯 Found '" << target << "' at depth " << depth << endl;
+        return id;
+    }
+    for (uint32_t child = tree.node(id).firstChild; child != FlatFolderTree::NONE; child = tree.node(child).nextSibling) {
+        uint32_t hit = findFolder(tree, target, child, depth + 1);
+        if (hit != FlatFolderTree::NONE) return hit;
+    }
+    return FlatFolderTree::NONE;
+}
+
+// Parent indices turn path reconstruction into a walk up from the folder
+string getFolderPath(const FlatFolderTree& tree, uint32_t id) {
+    vector<string_view> parts;
+    for (; id != FlatFolderTree::NONE; id = tree.node(id).parent) parts.push_back(tree.folderName(id));
+    string path;
+    for (size_t i = parts.size(); i-- > 0;) {
+        path += parts[i];
+        if (i) path += '/';
+    }
+    return path;
+}
+
+// 🧭 FolderPathIndex: "where is folder X" without searching the tree.
+// An open-addressing hash table maps folder names to node ids of a
+// FlatFolderTree; the tree's parent indices then give the full path in
+// O(depth). Slots hold ids and cached hashes rather than string keys, so the
+// index stays valid when the tree's name arena grows. Folders sharing a name
+// are chained through sameName in id order; lookups return the first one.
+class FolderPathIndex {
+    struct Slot {
+        uint32_t hash;
+        uint32_t id; // FlatFolderTree::NONE when empty
+    };
+    
+    FlatFolderTree& tree;
+    vector<Slot> slots;        // power-of-two size, kept at most half full
+    vector<uint32_t> sameName; // next folder (by id) with the same name
+    vector<uint32_t> lastSameName; // tail of each chain, indexed by its head
+    size_t distinctNames = 0;
+    
+    static uint32_t hashName(string_view name) {
+        uint64_t h = 1469598103934665603ull; // FNV-1a
+        for (unsigned char c : name) h = (h ^ c) * 1099511628211ull;
+        return (uint32_t)(h ^ (h >> 32));
+    }
+    
+    size_t probe(uint32_t hash, string_view name) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.id == FlatFolderTree::NONE) return i;
+            if (slot.hash == hash && tree.folderName(slot.id) == name) return i;
+        }
+    }
+    
+    void grow() {
+        vector<Slot> old(max<size_t>(16, slots.size() * 2), Slot{0, FlatFolderTree::NONE});
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.id == FlatFolderTree::NONE) continue;
+            size_t i = slot.hash & mask;
+            while (slots[i].id != FlatFolderTree::NONE) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+    
+    void indexFolder(uint32_t id) {
+        if ((distinctNames + 1) * 2 > slots.size()) grow();
+        string_view name = tree.folderName(id);
+        uint32_t hash = hashName(name);
+        Slot& slot = slots[probe(hash, name)];
+        sameName.push_back(FlatFolderTree::NONE);
+        lastSameName.push_back(id);
+        if (slot.id == FlatFolderTree::NONE) {
+            slot = {hash, id};
+            distinctNames++;
+        } else {
+            sameName[lastSameName[slot.id]] = id;
+            lastSameName[slot.id] = id;
+        }
+    }
+    
+public:
+    explicit FolderPathIndex(FlatFolderTree& indexedTree) : tree(indexedTree) {
+        size_t capacity = 16;
+        while (capacity < tree.folderCount() * 2) capacity *= 2;
+        slots.assign(capacity, Slot{0, FlatFolderTree::NONE});
+        sameName.reserve(tree.folderCount());
+        lastSameName.reserve(tree.folderCount());
+        for (uint32_t id = 0; id < tree.folderCount(); id++) indexFolder(id);
+    }
+    
+    // Adds a folder to the tree and to the index in one step
+    uint32_t addFolder(uint32_t parent, string_view name) {
+        uint32_t id = tree.addFolder(parent, name);
+        indexFolder(id);
+        return id;
+    }
+    
+    // First folder with this name, or NONE
+    uint32_t find(string_view name) const {
+        return slots[probe(hashName(name), name)].id;
+    }
+    
+    // Next folder with the same name as id, or NONE
+    uint32_t nextWithSameName(uint32_t id) const { return sameName[id]; }
+    
+    // Full path of a folder: one pass up the parent chain to size the
+    // string, a second to fill it from the back
+    string pathOf(uint32_t id) const {
+        size_t length = 0;
+        for (uint32_t at = id; at != FlatFolderTree::NONE; at = tree.node(at).parent) {
+            length += tree.folderName(at).size() + 1;
+        }
+        string path(length ? length - 1 : 0, '/');
+        size_t end = path.size();
+        for (uint32_t at = id; at != FlatFolderTree::NONE; at = tree.node(at).parent) {
+            string_view name = tree.folderName(at);
+            end -= name.size();
+            name.copy(&path[end], name.size());
+            if (end) end--; // skip the separator already in place
+        }
+        return path;
+    }
+    
+    // Resolves many names at once. Hashes for a block of queries are computed
+    // first and their home slots prefetched, so the table misses of a block
+    // overlap instead of being paid one after another. Missing names give "".
+    vector<string> lookupPaths(const vector<string>& names) const {
+        constexpr size_t BLOCK = 16;
+        vector<string> paths(names.size());
+        uint32_t hashes[BLOCK];
+        size_t mask = slots.size() - 1;
+        for (size_t start = 0; start < names.size(); start += BLOCK) {
+            size_t count = min(BLOCK, names.size() - start);
+            for (size_t k = 0; k < count; k++) {
+                hashes[k] = hashName(names[start + k]);
+#if defined(__GNUC__)
+                __builtin_prefetch(&slots[hashes[k] & mask]);
+#endif
+            }
+            for (size_t k = 0; k < count; k++) {
+                uint32_t id = slots[probe(hashes[k], names[start + k])].id;
+                if (id != FlatFolderTree::NONE) paths[start + k] = pathOf(id);
+            }
+        }
+        return paths;
+    }
+    
+    size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Slot) + (sameName.capacity() + lastSameName.capacity()) * sizeof(uint32_t);
+    }
+};
+
+// Builds a single chain of nested folders, bottom-up so nothing recurses
+Folder buildFolderChain(int depth) {
+    Folder chain("level_" + to_string(depth - 1), {}, {"leaf.txt"});
+    for (int d = depth - 2; d >= 0; d--) {
+        Folder parent("level_" + to_string(d));
+        parent.subFolders.push_back(std::move(chain));
+        chain = std::move(parent);
+    }
+    return chain;
+}
+
+// Builds a complete tree with the given fanout and depth, two files per folder
+Folder buildFolderTree(int fanout, int depth, const string& name = "root") {
+    Folder f(name, {}, {name + ".txt", name + ".log"});
+    if (depth > 0) {
+        for (int i = 0; i < fanout; i++) {
+            f.subFolders.push_back(buildFolderTree(fanout, depth - 1, name + "_" + to_string(i)));
         }
     }
+    return f;
 }
 
-int main() {
+// Deep-chain stress test plus recursive vs iterative throughput on a wide tree
+void runStressTest(int depth) {
+    cout << "=== 🧪 Deep Hierarchy Stress Test (depth = " << depth << ") ===\n\n";
+    
+    auto start = high_resolution_clock::now();
+    Folder chain = buildFolderChain(depth);
+    auto built = high_resolution_clock::now();
+    long long items = calculateSizeIterative(chain);
+    auto sized = high_resolution_clock::now();
+    bool found = findFolderIterative(chain, "level_" + to_string(depth - 1));
+    auto searched = high_resolution_clock::now();
+    
+    cout << "├── Build chain: " << duration_cast<milliseconds>(built - start).count() << " ms\n";
+    cout << "├── calculateSizeIterative: " << items << " items in "
+         << duration_cast<milliseconds>(sized - built).count() << " ms\n";
+    cout << "├── findFolderIterative (deepest): " << (found ? "found" : "missing") << " in "
+         << duration_cast<milliseconds>(searched - sized).count() << " ms\n";
+    cout << "└── Recursive versions skipped: one stack frame per level would overflow the call stack\n\n";
+    
+    int fanout = 4, treeDepth = 9;
+    Folder wide = buildFolderTree(fanout, treeDepth);
+    cout << fixed << setprecision(2);
+    cout << "⚖️ Throughput on a complete tree (fanout " << fanout << ", depth " << treeDepth << "):\n";
+    
+    auto timeIt = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        long long result = 0;
+        for (int rep = 0; rep < 5; rep++) result += fn();
+        auto t1 = high_resolution_clock::now();
+        return make_pair(result / 5, duration_cast<microseconds>(t1 - t0).count() / 5.0 / 1000.0);
+    };
+    auto recursiveSize = timeIt([&] { return (long long)calculateSize(wide); });
+    auto iterativeSize = timeIt([&] { return calculateSizeIterative(wide); });
+    auto recursiveFind = timeIt([&] { return (long long)findFolder(wide, "missing"); });
+    auto iterativeFind = timeIt([&] { return (long long)findFolderIterative(wide, "missing"); });
+    
+    cout << "├── calculateSize:  recursive " << recursiveSize.second << " ms | iterative "
+         << iterativeSize.second << " ms (" << recursiveSize.first << " / " << iterativeSize.first << " items)\n";
+    cout << "└── findFolder (miss): recursive " << recursiveFind.second << " ms | iterative "
+         << iterativeFind.second << " ms\n";
+}
+
+// A deep "caterpillar": a spine of spineLength folders, each with `legs` leaf subfolders
+Folder buildCaterpillar(int spineLength, int legs) {
+    auto makeSpine = [legs](int d) {
+        Folder f("spine_" + to_string(d), {}, {"part.bin"});
+        for (int i = 0; i < legs; i++) f.subFolders.push_back(Folder("leg_" + to_string(d) + "_" + to_string(i), {}, {"a.txt", "b.txt"}));
+        return f;
+    };
+    Folder chain = makeSpine(spineLength - 1);
+    for (int d = spineLength - 2; d >= 0; d--) {
+        Folder parent = makeSpine(d);
+        parent.subFolders.push_back(std::move(chain));
+        chain = std::move(parent);
+    }
+    return chain;
+}
+
+// Speedup curves for the work-stealing walker on a wide and a deep tree
+void runParallelBenchmark(int maxThreads) {
+    cout << "=== ⚡ Parallel Folder Aggregation (hardware threads: "
+         << thread::hardware_concurrency() << ") ===\n";
+    
+    vector<int> threadCounts;
+    for (int t = 1; t <= maxThreads; t *= 2) threadCounts.push_back(t);
+    cout << fixed << setprecision(2);
+    
+    auto timeMs = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        fn();
+        return duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+    };
+    
+    auto curve = [&](const string& label, const Folder& root) {
+        long long serialItems = 0;
+        double serial = timeMs([&] { serialItems = calculateSizeIterative(root); });
+        cout << "\n🌲 " << label << " — serial iterative: " << serial << " ms (" << serialItems << " items)\n";
+        double base = 0;
+        for (int t : threadCounts) {
+            FolderStats stats;
+            double ms = timeMs([&] { stats = calculateStatsParallel(root, t); });
+            if (t == 1) base = ms;
+            cout << "├── " << setw(2) << t << " threads: " << setw(8) << ms << " ms | speedup "
+                 << setw(5) << base / ms << "x | folders " << stats.folders << ", files " << stats.files
+                 << ", max depth " << stats.maxDepth
+                 << (stats.folders + stats.files == serialItems ? "" : " ⚠️ mismatch") << "\n";
+        }
+    };
+    
+    Folder wide = buildFolderTree(8, 6);
+    curve("Wide tree (fanout 8, depth 6)", wide);
+    Folder deep = buildCaterpillar(50000, 8);
+    curve("Deep tree (50000-folder spine, 8 leaves per level)", deep);
+    
+    // Search with cancellation: the target is the last folder in pre-order
+    string target = "root_7_7_7_7_7_7";
+    cout << "\n🔍 findFolder('" << target << "') on the wide tree:\n";
+    double serial = timeMs([&] { findFolderIterative(wide, target); });
+    cout << "├── serial iterative: " << serial << " ms\n";
+    for (int t : threadCounts) {
+        int depth = -1;
+        long long visited = 0;
+        const Folder* hit = nullptr;
+        double ms = timeMs([&] { hit = findFolderParallel(wide, target, t, depth, &visited); });
+        cout << "├── " << setw(2) << t << " threads: " << setw(8) << ms << " ms | "
+             << (hit ? "found at depth " + to_string(depth) : string("not found"))
+             << " after visiting " << visited << " folders\n";
+    }
+    int depth = -1;
+    long long visited = 0;
+    findFolderParallel(wide, "missing", maxThreads, depth, &visited);
+    cout << "└── missing target, " << maxThreads << " threads: visited all " << visited << " folders\n";
+}
+
+// Complete tree with numbered folder names and filesPerFolder files each, in pre-order
+Folder buildNumberedFolder(int fanout, int depth, int filesPerFolder, long long& counter) {
+    Folder f("dir" + to_string(counter++));
+    f.files.reserve(filesPerFolder);
+    for (int k = 0; k < filesPerFolder; k++) f.files.push_back("file" + to_string(k) + ".dat");
+    if (depth > 0) {
+        f.subFolders.reserve(fanout);
+        for (int i = 0; i < fanout; i++) f.subFolders.push_back(buildNumberedFolder(fanout, depth - 1, filesPerFolder, counter));
+    }
+    return f;
+}
+
+// The same tree appended straight into a FlatFolderTree
+void buildNumberedFlat(FlatFolderTree& tree, uint32_t parent, int fanout, int depth, int filesPerFolder, long long& counter) {
+    uint32_t id = tree.addFolder(parent, "dir" + to_string(counter++));
+    for (int k = 0; k < filesPerFolder; k++) tree.addFile("file" + to_string(k) + ".dat");
+    if (depth > 0) {
+        for (int i = 0; i < fanout; i++) buildNumberedFlat(tree, id, fanout, depth - 1, filesPerFolder, counter);
+    }
+}
+
+// Heap bytes and allocations owned by a nested Folder (malloc headers not included)
+pair<size_t, size_t> folderFootprint(const Folder& root) {
+    size_t bytes = sizeof(Folder), allocations = 0;
+    auto stringHeap = [&](const string& s) {
+        if (s.capacity() > 15) { bytes += s.capacity() + 1; allocations++; } // libstdc++ SSO holds 15 chars
+    };
+    for (const FolderVisit& visit : FolderWalker(root)) {
+        const Folder& f = *visit.folder;
+        stringHeap(f.name);
+        if (f.subFolders.capacity()) { bytes += f.subFolders.capacity() * sizeof(Folder); allocations++; }
+        if (f.files.capacity()) { bytes += f.files.capacity() * sizeof(string); allocations++; }
+        for (const string& file : f.files) stringHeap(file);
+    }
+    return {bytes, allocations};
+}
+
+// Nested vs flattened representation on a large generated hierarchy
+void runFlatBenchmark(long long entries) {
+    const int fanout = 10, filesPerFolder = 9;
+    int depth = 0;
+    long long folders = 1;
+    for (long long level = 1; folders * (1 + filesPerFolder) < entries && depth < 8; depth++) {
+        level *= fanout;
+        folders += level;
+    }
+    cout << "=== 🗜️ Nested vs Flattened Folders (" << folders << " folders, "
+         << folders * (1 + filesPerFolder) << " entries) ===\n\n";
+    cout << fixed << setprecision(1);
+    
+    auto timeMs = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        fn();
+        return duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+    };
+    
+    long long counter = 0;
+    unique_ptr<Folder> nested;
+    double nestedBuild = timeMs([&] { nested = make_unique<Folder>(buildNumberedFolder(fanout, depth, filesPerFolder, counter)); });
+    pair<size_t, size_t> nestedMemory = folderFootprint(*nested);
+    
+    counter = 0;
+    FlatFolderTree flat;
+    double flatBuild = timeMs([&] {
+        size_t nameBytes = (size_t)folders * filesPerFolder * 9; // "fileK.dat"
+        for (long long id = 0; id < folders; id++) nameBytes += 3 + to_string(id).size();
+        flat.reserve(folders, folders * filesPerFolder, nameBytes);
+        buildNumberedFlat(flat, FlatFolderTree::NONE, fanout, depth, filesPerFolder, counter);
+        flat.shrinkToFit();
+    });
+    
+    long long nestedSize = 0, flatSize = 0;
+    double nestedWalk = timeMs([&] { nestedSize = calculateSize(*nested); });
+    double flatWalk = timeMs([&] { flatSize = calculateSize(flat); });
+    double nestedFind = timeMs([&] { findFolder(*nested, "missing"); });
+    double flatFind = timeMs([&] { findFolder(flat, "missing"); });
+    double convert = timeMs([&] { FlatFolderTree copy(*nested); });
+    double nestedFree = timeMs([&] { nested.reset(); });
+    
+    auto row = [](const string& label, double nestedValue, double flatValue, const string& unit) {
+        cout << "├── " << left << setw(22) << label << right << setw(10) << nestedValue << " " << unit
+             << " | " << setw(10) << flatValue << " " << unit << " | ";
+        if (nestedValue > 0 && flatValue > 0) cout << setw(5) << nestedValue / flatValue << "x\n";
+        else cout << "    -\n";
+    };
+    cout << "                             nested Folder  |   FlatFolderTree\n";
+    row("Memory", nestedMemory.first / 1048576.0, flat.memoryBytes() / 1048576.0, "MB");
+    row("Build", nestedBuild, flatBuild, "ms");
+    row("calculateSize", nestedWalk, flatWalk, "ms");
+    row("findFolder (miss)", nestedFind, flatFind, "ms");
+    cout << "├── Heap blocks: " << nestedMemory.second << " nested vs 3 flat (node, file and name arrays)\n";
+    cout << "├── Nested teardown: " << nestedFree << " ms (flat frees three blocks)\n";
+    cout << "├── Folder -> FlatFolderTree conversion: " << convert << " ms\n";
+    cout << "└── Items counted: " << nestedSize << " / " << flatSize
+         << (nestedSize == flatSize ? " ✅" : " ⚠️ mismatch") << "\n";
+}
+
+// Path queries: DFS per query vs FolderPathIndex, single and batched, plus
+// incremental inserts
+void runPathIndexBenchmark(long long targetFolders, int queries) {
+    const int fanout = 10, filesPerFolder = 1;
+    int depth = 0;
+    long long folders = 1;
+    for (long long level = 1; folders < targetFolders && depth < 8; depth++) {
+        level *= fanout;
+        folders += level;
+    }
+    cout << "=== 🧭 Folder Path Index (" << folders << " folders, depth " << depth << ") ===\n\n";
+    cout << fixed << setprecision(2);
+    
+    auto timeMs = [](auto&& fn) {
+        auto t0 = high_resolution_clock::now();
+        fn();
+        return duration_cast<microseconds>(high_resolution_clock::now() - t0).count() / 1000.0;
+    };
+    
+    long long counter = 0;
+    Folder nested = buildNumberedFolder(fanout, depth, filesPerFolder, counter);
+    counter = 0;
+    FlatFolderTree flat;
+    buildNumberedFlat(flat, FlatFolderTree::NONE, fanout, depth, filesPerFolder, counter);
+    
+    unique_ptr<FolderPathIndex> index;
+    double buildMs = timeMs([&] { index = make_unique<FolderPathIndex>(flat); });
+    cout << "🏗️ Index build: " << buildMs << " ms, " << index->memoryBytes() / 1024 << " KB\n\n";
+    
+    mt19937 rng(42);
+    vector<string> names(queries);
+    for (string& name : names) name = "dir" + to_string(rng() % folders);
+    
+    // DFS answers a query by walking the tree, so only a sample is timed
+    int dfsQueries = min(queries, 200);
+    vector<string> dfsPaths(dfsQueries);
+    double dfsMs = timeMs([&] {
+        for (int i = 0; i < dfsQueries; i++) findFolderPath(nested, names[i], dfsPaths[i]);
+    });
+    vector<string> singlePaths(queries);
+    double singleMs = timeMs([&] {
+        for (int i = 0; i < queries; i++) singlePaths[i] = index->pathOf(index->find(names[i]));
+    });
+    vector<string> batchPaths;
+    double batchMs = timeMs([&] { batchPaths = index->lookupPaths(names); });
+    
+    bool agree = batchPaths == singlePaths;
+    for (int i = 0; i < dfsQueries; i++) agree = agree && dfsPaths[i] == singlePaths[i];
+    
+    auto perQuery = [](double ms, int n) { return ms * 1e6 / n; };
+    cout << "🔍 " << queries << " path queries (random folder names):\n";
+    cout << "├── DFS findFolderPath:       " << setw(12) << perQuery(dfsMs, dfsQueries) << " ns/query (" << dfsQueries << " sampled)\n";
+    cout << "├── Index find + pathOf:      " << setw(12) << perQuery(singleMs, queries) << " ns/query\n";
+    cout << "├── Index lookupPaths (batch):" << setw(12) << perQuery(batchMs, queries) << " ns/query\n";
+    cout << "└── Results agree: " << (agree ? "✅" : "⚠️ mismatch") << "\n\n";
+    
+    // Incremental maintenance: new folders under random existing ones
+    int inserts = 100000;
+    vector<uint32_t> added(inserts);
+    double insertMs = timeMs([&] {
+        for (int i = 0; i < inserts; i++) {
+            uint32_t parent = rng() % flat.folderCount();
+            added[i] = index->addFolder(parent, "new" + to_string(i));
+        }
+    });
+    bool insertsOk = true;
+    for (int i = 0; i < inserts; i += 997) {
+        string path = index->pathOf(index->find("new" + to_string(i)));
+        string expected = index->pathOf(flat.node(added[i]).parent) + "/new" + to_string(i);
+        insertsOk = insertsOk && index->find("new" + to_string(i)) == added[i] && path == expected;
+    }
+    cout << "➕ " << inserts << " incremental inserts: " << perQuery(insertMs, inserts) << " ns/insert, "
+         << "lookups after insert " << (insertsOk ? "✅" : "⚠️ wrong") << "\n";
+    cout << "   e.g. " << index->pathOf(added.back()) << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--paths") {
+        long long folders = argc > 2 ? atoll(argv[2]) : 1000000;
+        int queries = argc > 3 ? atoi(argv[3]) : 100000;
+        runPathIndexBenchmark(max(1LL, folders), max(1, queries));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--flat") {
+        long long entries = argc > 2 ? atoll(argv[2]) : 10000000;
+        runFlatBenchmark(entries > 0 ? entries : 10000000);
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "--scan") {
+        int threads = argc > 3 ? atoi(argv[3]) : (int)max(4u, thread::hardware_concurrency());
+        runDirectoryScan(argv[2], max(1, threads));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--parallel") {
+        int threads = argc > 2 ? atoi(argv[2]) : (int)max(4u, thread::hardware_concurrency());
+        runParallelBenchmark(max(1, threads));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--stress") {
+        int depth = argc > 2 ? atoi(argv[2]) : 1000000;
+        runStressTest(depth > 1 ? depth : 1000000);
+        return 0;
+    }
+    
     // Reset counters
     folderCount = fileCount = maxDepth = 0;
     
@@ -174,19 +1463,45 @@ int main() {
     for (const string& target : searchTargets) {
         cout << "\nSearching for '" << target << "':\n";
         if (findFolder(myComputer, target)) {
-            bool found = false;
-            getFolderPath(myComputer, target, "", found);
+            getFolderPath(myComputer, target);
         } else {
             cout << "❌ Folder '" << target << "' not found\n";
         }
     }
 
+    // Same answers without using the call stack
+    cout << "\n🔁 Iterative versions (explicit stack via FolderWalker):\n";
+    cout << "├── Total Items: " << calculateSizeIterative(myComputer) << endl;
+    cout << "└── ";
+    findFolderIterative(myComputer, "Beach_2023");
+
+    // Same answers from the flattened representation
+    FlatFolderTree flatComputer(myComputer);
+    cout << "\n🗜️ Flattened copy (" << flatComputer.folderCount() << " folders, " << flatComputer.fileCount()
+         << " files, " << flatComputer.memoryBytes() << " bytes):\n";
+    cout << "├── Total Items: " << calculateSize(flatComputer) << endl;
+    cout << "└── ";
+    uint32_t beach = findFolder(flatComputer, "Beach_2023");
+    if (beach != FlatFolderTree::NONE) cout << "    📍 Full path: " << getFolderPath(flatComputer, beach) << endl;
+
+    // Name -> id hash plus parent indices: paths without any tree search
+    FolderPathIndex pathIndex(flatComputer);
+    pathIndex.addFolder(pathIndex.find("Python"), "notebooks");
+    cout << "\n🧭 Path index lookups (batched):\n";
+    vector<string> queries = {"Projects", "Beach_2023", "notebooks", "NonExistent"};
+    vector<string> paths = pathIndex.lookupPaths(queries);
+    for (size_t i = 0; i < queries.size(); i++) {
+        cout << (i + 1 == queries.size() ? "└── " : "├── ") << queries[i] << " → "
+             << (paths[i].empty() ? "❌ not found" : paths[i]) << endl;
+    }
+
     cout << "\n🧩 Recursion Concepts Demonstrated:\n";
     cout << "• 🔄 Self-similar problem: Each folder contains subfolders\n";
     cout << "• 📏 Base case: Folder with no subfolders\n";
     cout << "• 🔁 Recursive case: Process current folder, then recurse on subfolders\n";
     cout << "• 📈 Call stack depth corresponds to folder nesting level\n";
-    cout << "• 🎯 Backtracking: Return from deep folders to explore siblings\n\n";
+    cout << "• 🎯 Backtracking: Return from deep folders to explore siblings\n";
+    cout << "• 📚 Any recursion can become a loop over an explicit stack\n\n";
 
     cout << "💡 Real-world Applications:\n";
     cout << "• File system navigation (Windows Explorer, Finder)\n";
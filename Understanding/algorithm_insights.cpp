@@ -1,8 +1,19 @@
 // algorithm_insights.cpp
 // Single-file interactive demo to learn data structures & complexity.
-// Compile: g++ -std=c++17 -O2 algorithm_insights.cpp -o algorithm_insights
+// Compile: g++ -std=c++17 -O2 -pthread algorithm_insights.cpp -o algorithm_insights
 
 #include <bits/stdc++.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 using namespace std;
 using steady_clock_t = std::chrono::steady_clock;
 using ms = std::chrono::milliseconds;
@@ -24,7 +35,7 @@ double time_ms(F&& f, Args&&... args) {
     return t.elapsed_ms();
 }
 
-void pause() {
+void wait_for_enter() {
     cout << "\nPress Enter to continue..."; cin.ignore(numeric_limits<streamsize>::max(), '\n');
 }
 
@@ -175,7 +186,7 @@ void demo_arrays_search_sort() {
 
     cout << "\n(Notice how bubble/insertion explode for large n if data random - they are O(n^2). Merge/Quick are ~O(n log n)).\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Section B: Recursion ///////////////////////
@@ -222,7 +233,7 @@ void demo_recursion() {
     cout << "fib_memo("<<n<<")="<<fm<<", calls="<<fib_calls_memo<<", time(ms)="<<tmemo<<"\n";
     cout << "Observation: naive uses exponential calls ~O(2^n); memoized is O(n).\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Section C: Stacks & Queues ///////////////////////
@@ -310,10 +321,44 @@ void demo_stack_queue() {
     }
     cout << "Remaining in queue: " << q.size() << "\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Section D: Linked Lists ///////////////////////
+// Typed slab pool for list/tree nodes: nodes are carved from ~64 KB slabs,
+// freed nodes are reused through an intrusive free list, and all slabs are
+// released together when the pool goes away (so owners need no node-by-node
+// cleanup). Limited to trivially destructible nodes (SNode, DNode, BSTNode).
+template<typename T>
+class NodePool {
+    static_assert(is_trivially_destructible<T>::value, "bulk free skips destructors");
+    union Slot { Slot* next; alignas(T) unsigned char raw[sizeof(T)]; };
+    static constexpr size_t PER_SLAB = max<size_t>(8, 65536 / sizeof(Slot));
+    vector<unique_ptr<Slot[]>> slabs;
+    Slot* free_list = nullptr;
+    size_t used = PER_SLAB, live = 0;
+public:
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    template<typename... A> T* create(A&&... a) {
+        Slot* s;
+        if(free_list) { s = free_list; free_list = s->next; }
+        else {
+            if(used == PER_SLAB) { slabs.emplace_back(new Slot[PER_SLAB]); used = 0; }
+            s = &slabs.back()[used++];
+        }
+        ++live;
+        return new (s->raw) T(std::forward<A>(a)...);
+    }
+    void destroy(T* p) {
+        Slot* s = reinterpret_cast<Slot*>(p);
+        s->next = free_list; free_list = s; --live;
+    }
+    size_t size() const { return live; }
+    size_t slab_count() const { return slabs.size(); }
+};
+
 struct SNode {
     int val; SNode* next;
     SNode(int v): val(v), next(nullptr){}
@@ -326,12 +371,13 @@ struct DNode {
 class SinglyLinkedList {
 public:
     SNode* head;
+    NodePool<SNode> pool; // owns every node; released with the list
     SinglyLinkedList(): head(nullptr){}
     void push_front(int v) {
-        SNode* n = new SNode(v); n->next=head; head=n;
+        SNode* n = pool.create(v); n->next=head; head=n;
     }
     void push_back(int v) {
-        SNode* n = new SNode(v);
+        SNode* n = pool.create(v);
         if(!head) { head=n; return; }
         SNode* cur=head; while(cur->next) cur=cur->next; cur->next=n;
     }
@@ -343,7 +389,7 @@ public:
                 SNode* to = prev->next;
                 prev->next = to->next;
                 if(to==head) head = prev->next;
-                delete to;
+                pool.destroy(to);
                 head = dummy.next;
                 return true;
             }
@@ -397,7 +443,7 @@ void demo_linked_list() {
         for(int x: order) cout<<x<<" "; cout<<"\n";
     }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Section E: Trees (BST) ///////////////////////
@@ -407,21 +453,38 @@ struct BSTNode {
     BSTNode(int k): key(k), left(nullptr), right(nullptr){}
 };
 
-BSTNode* bst_insert(BSTNode* root, int key) {
-    if(!root) return new BSTNode(key);
-    if(key < root->key) root->left = bst_insert(root->left, key);
-    else root->right = bst_insert(root->right, key);
+// Iterative so that degenerate (sorted-input) trees of height n cannot overflow the call stack.
+// Nodes come from the caller's pool, which frees the whole tree at once.
+BSTNode* bst_insert(BSTNode* root, int key, NodePool<BSTNode>& pool) {
+    BSTNode** link = &root;
+    while(*link) link = (key < (*link)->key) ? &(*link)->left : &(*link)->right;
+    *link = pool.create(key);
     return root;
 }
 bool bst_search(BSTNode* root, int key) {
-    if(!root) return false;
-    if(root->key == key) return true;
-    if(key < root->key) return bst_search(root->left, key);
-    return bst_search(root->right, key);
+    while(root) {
+        if(root->key == key) return true;
+        root = (key < root->key) ? root->left : root->right;
+    }
+    return false;
 }
-void bst_inorder(BSTNode* root) {
-    if(!root) return;
-    bst_inorder(root->left); cout<<root->key<<" "; bst_inorder(root->right);
+void bst_inorder(BSTNode* root, int limit = INT_MAX) {
+    vector<BSTNode*> st;
+    while((root || !st.empty()) && limit > 0) {
+        while(root) { st.push_back(root); root = root->left; }
+        root = st.back(); st.pop_back();
+        cout<<root->key<<" "; --limit;
+        root = root->right;
+    }
+}
+int bst_height(BSTNode* root) {
+    int h = 0; vector<BSTNode*> level; if(root) level.push_back(root);
+    while(!level.empty()) {
+        ++h; vector<BSTNode*> next;
+        for(BSTNode* x: level) { if(x->left) next.push_back(x->left); if(x->right) next.push_back(x->right); }
+        level.swap(next);
+    }
+    return h;
 }
 
 void demo_trees() {
@@ -435,14 +498,16 @@ void demo_trees() {
     else if(mode==2) for(int i=n;i>=1;--i) keys.push_back(i);
     else { mt19937 rng(12345); for(int i=0;i<n;++i) keys.push_back((int)(rng()% (n*3))); }
     BSTNode* root = nullptr;
-    for(int k: keys) root = bst_insert(root, k);
-    cout << "Inorder traversal (first 50): "; bst_inorder(root); cout<<"\n";
+    NodePool<BSTNode> pool;
+    for(int k: keys) root = bst_insert(root, k, pool);
+    cout << "Inorder traversal (first 50): "; bst_inorder(root, 50); cout<<"\n";
+    cout << "Tree height: " << bst_height(root) << " (sorted input degrades to n; see Application/tree_structures.cpp for the AVL version)\n";
     cout << "Search for an element (enter key): ";
     int q; cin>>q;
     bool found = bst_search(root, q);
     cout << "Found? " << (found ? "Yes":"No") << "\n";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Section F: Graphs ///////////////////////
@@ -490,6 +555,197 @@ struct Graph {
     }
 };
 
+/////////////////////// Section F2: Shortest-path engine ///////////////////////
+// Routing-grade single-source / point-to-point shortest paths on top of a CSR copy of Graph.
+const long long SP_INF = (1LL<<60);
+
+// Compressed sparse row: out-edges of u are targets/weights[offsets[u] .. offsets[u+1]).
+struct CSRGraph {
+    int n = 0;
+    vector<long long> offsets;
+    vector<int> targets, weights;
+    CSRGraph() {}
+    explicit CSRGraph(const Graph& g): n(g.n), offsets(g.n+1, 0) {
+        for(int u=0;u<n;++u) offsets[u+1] = offsets[u] + (long long)g.adj[u].size();
+        targets.resize(offsets[n]); weights.resize(offsets[n]);
+        for(int u=0;u<n;++u) {
+            long long e = offsets[u];
+            for(auto &pr: g.adj[u]) { targets[e]=pr.first; weights[e]=pr.second; ++e; }
+        }
+    }
+    int degree(int u) const { return (int)(offsets[u+1]-offsets[u]); }
+    long long edges() const { return (long long)targets.size(); }
+};
+
+// Indexed D-ary min-heap over vertex ids with decrease-key.
+// pos[v] = slot of v in heap or -1; keys live beside the ids so a sift-down scans D children in one go.
+template<int D>
+struct IndexedDaryHeap {
+    vector<int> heap, pos;
+    vector<long long> key;
+    void reset(int n) { heap.clear(); pos.assign(n,-1); key.assign(n,SP_INF); }
+    void clear() { for(int v: heap) pos[v]=-1; heap.clear(); } // O(size), not O(n)
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void push_or_decrease(int v, long long k) {
+        if(pos[v]<0) { pos[v]=(int)heap.size(); heap.push_back(v); key[v]=k; sift_up(pos[v]); }
+        else if(k<key[v]) { key[v]=k; sift_up(pos[v]); }
+    }
+    int pop_min() {
+        int top = heap[0], last = heap.back();
+        heap.pop_back(); pos[top] = -1;
+        if(!heap.empty()) { heap[0]=last; pos[last]=0; sift_down(0); }
+        return top;
+    }
+private:
+    void sift_up(int i) {
+        int v = heap[i]; long long k = key[v];
+        while(i>0) {
+            int p = (i-1)/D;
+            if(key[heap[p]] <= k) break;
+            heap[i] = heap[p]; pos[heap[i]] = i; i = p;
+        }
+        heap[i] = v; pos[v] = i;
+    }
+    void sift_down(int i) {
+        int v = heap[i]; long long k = key[v]; int n = (int)heap.size();
+        while(true) {
+            int c = i*D+1;
+            if(c>=n) break;
+            int best = c; long long bk = key[heap[c]];
+            for(int j=c+1, end=min(c+D,n); j<end; ++j) if(key[heap[j]] < bk) { bk=key[heap[j]]; best=j; }
+            if(bk >= k) break;
+            heap[i] = heap[best]; pos[heap[i]] = i; i = best;
+        }
+        heap[i] = v; pos[v] = i;
+    }
+};
+
+// Radix heap for monotone integer keys (Dijkstra never inserts below the last popped key).
+// Bucket b holds keys whose highest bit differing from `last` is b-1, so every entry
+// is redistributed at most 64 times over its lifetime.
+struct RadixHeap {
+    vector<pair<unsigned long long,int>> buckets[65];
+    unsigned long long last = 0;
+    size_t sz = 0;
+    static int bucket_of(unsigned long long x, unsigned long long last) {
+        return x==last ? 0 : 64 - __builtin_clzll(x^last);
+    }
+    void clear() { for(auto &b: buckets) b.clear(); last=0; sz=0; }
+    bool empty() const { return sz==0; }
+    void push(unsigned long long k, int v) { buckets[bucket_of(k,last)].push_back({k,v}); ++sz; }
+    pair<unsigned long long,int> pop() {
+        if(buckets[0].empty()) {
+            int b = 1; while(buckets[b].empty()) ++b;
+            unsigned long long mn = ULLONG_MAX;
+            for(auto &e: buckets[b]) mn = min(mn, e.first);
+            last = mn;
+            for(auto &e: buckets[b]) buckets[bucket_of(e.first,last)].push_back(e);
+            buckets[b].clear();
+        }
+        auto e = buckets[0].back(); buckets[0].pop_back(); --sz;
+        return e;
+    }
+};
+
+// Reusable query engine: workspaces are sized once and only touched vertices are reset
+// between queries, so a point-to-point query costs O(settled region), not O(n).
+class ShortestPathEngine {
+    const CSRGraph& g;
+    vector<long long> dist;
+    vector<int> parent, touched;
+    IndexedDaryHeap<4> heap;
+    RadixHeap rheap;
+    long long settled_ = 0;
+
+    void begin(int s) {
+        for(int v: touched) { dist[v]=SP_INF; parent[v]=-1; }
+        touched.clear(); heap.clear(); rheap.clear(); settled_ = 0;
+        update(s, 0, -1);
+    }
+    void update(int v, long long d, int p) {
+        if(dist[v]==SP_INF) touched.push_back(v);
+        dist[v] = d; parent[v] = p;
+    }
+public:
+    explicit ShortestPathEngine(const CSRGraph& graph): g(graph), dist(graph.n, SP_INF), parent(graph.n, -1) {
+        heap.reset(graph.n);
+    }
+
+    // Dijkstra with the indexed 4-ary heap. target<0 settles everything; otherwise stops once target is settled.
+    long long dijkstra(int s, int target=-1) {
+        begin(s); heap.push_or_decrease(s, 0);
+        while(!heap.empty()) {
+            int u = heap.pop_min(); ++settled_;
+            if(u==target) break;
+            long long du = dist[u];
+            for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) {
+                int v = g.targets[e]; long long nd = du + g.weights[e];
+                if(nd < dist[v]) { update(v, nd, u); heap.push_or_decrease(v, nd); }
+            }
+        }
+        return target<0 ? 0 : dist[target];
+    }
+
+    // Dijkstra with the radix heap (integer weights only); stale entries are skipped lazily.
+    long long dijkstra_radix(int s, int target=-1) {
+        begin(s); rheap.push(0, s);
+        while(!rheap.empty()) {
+            auto top = rheap.pop();
+            int u = top.second;
+            if((long long)top.first != dist[u]) continue;
+            ++settled_;
+            if(u==target) break;
+            long long du = dist[u];
+            for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) {
+                int v = g.targets[e]; long long nd = du + g.weights[e];
+                if(nd < dist[v]) { update(v, nd, u); rheap.push(nd, v); }
+            }
+        }
+        return target<0 ? 0 : dist[target];
+    }
+
+    // A* search; h(v) must be a consistent lower bound on the distance from v to target.
+    template<typename Heuristic>
+    long long astar(int s, int target, Heuristic h) {
+        begin(s); heap.push_or_decrease(s, h(s));
+        while(!heap.empty()) {
+            int u = heap.pop_min(); ++settled_;
+            if(u==target) break;
+            long long du = dist[u];
+            for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) {
+                int v = g.targets[e]; long long nd = du + g.weights[e];
+                if(nd < dist[v]) { update(v, nd, u); heap.push_or_decrease(v, nd + h(v)); }
+            }
+        }
+        return dist[target];
+    }
+
+    long long distance(int v) const { return dist[v]; }
+    long long settled() const { return settled_; }
+    vector<int> path_to(int t) const {
+        vector<int> path;
+        if(dist[t]>=SP_INF) return path;
+        for(int v=t; v!=-1; v=parent[v]) path.push_back(v);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+};
+
+// Road-network-like grid: two-way 4-neighbour streets with travel times in [10,100].
+// Every edge costs at least 10, so 10 * manhattan distance is a consistent A* heuristic.
+Graph make_grid_graph(int rows, int cols, unsigned seed=42) {
+    Graph g(rows*cols);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> wt(10, 100);
+    for(int r=0;r<rows;++r) for(int c=0;c<cols;++c) {
+        int u = r*cols + c;
+        if(c+1<cols) { int w = wt(rng); g.add_edge(u, u+1, w); g.add_edge(u+1, u, w); }
+        if(r+1<rows) { int w = wt(rng); g.add_edge(u, u+cols, w); g.add_edge(u+cols, u, w); }
+    }
+    return g;
+}
+
 void demo_graphs() {
     cout << "=== Graphs Demo ===\n";
     cout << "We'll build a small directed graph with 6 nodes.\n";
@@ -509,7 +765,986 @@ void demo_graphs() {
         cout << i << ":" << (d[i] >= (1LL<<50) ? -1 : d[i]) << " ";
     }
     cout << "\n";
-    pause();
+    wait_for_enter();
+}
+
+void demo_shortest_paths() {
+    cout << "=== Shortest-Path Engine Benchmark (road-like grid) ===\n";
+    cout << "Grid side (e.g., 1000 -> 10^6 nodes, 3163 -> 10^7 nodes): ";
+    int side;
+    if(!(cin>>side) || side<2) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); return; }
+    Timer tb;
+    Graph g = make_grid_graph(side, side);
+    CSRGraph csr(g);
+    int n = g.n;
+    cout << "Built " << n << " nodes / " << csr.edges() << " edges in " << tb.elapsed_ms() << " ms\n";
+
+    cout << "\n-- Full single-source runs from node 0 --\n";
+    vector<long long> base;
+    double t0 = time_ms([&]{ base = g.dijkstra(0); });
+    ShortestPathEngine eng(csr);
+    auto matches = [&]{ for(int v=0;v<n;++v) if(eng.distance(v)!=base[v]) return false; return true; };
+    double t1 = time_ms([&]{ eng.dijkstra(0); });
+    bool ok1 = matches();
+    double t2 = time_ms([&]{ eng.dijkstra_radix(0); });
+    bool ok2 = matches();
+    cout << "Graph::dijkstra (binary heap, lazy) time(ms)=" << t0 << "\n";
+    cout << "CSR + indexed 4-ary heap           time(ms)=" << t1 << (ok1 ? "  [distances match]" : "  [MISMATCH]") << "\n";
+    cout << "CSR + radix heap                   time(ms)=" << t2 << (ok2 ? "  [distances match]" : "  [MISMATCH]") << "\n";
+
+    int Q = 20;
+    cout << "\n-- " << Q << " random point-to-point queries (early exit on target) --\n";
+    std::mt19937 rng(7);
+    auto manhattan = [&](int t){
+        int tr = t/side, tc = t%side;
+        return [=](int v){ return 10LL * (abs(v/side - tr) + abs(v%side - tc)); };
+    };
+    double td=0, tr=0, ta=0; long long sd=0, sr=0, sa=0; bool agree = true;
+    for(int q=0;q<Q;++q) {
+        int s = (int)(rng()%n), t = (int)(rng()%n);
+        long long dd=0, dr=0, da=0;
+        td += time_ms([&]{ dd = eng.dijkstra(s, t); }); sd += eng.settled();
+        tr += time_ms([&]{ dr = eng.dijkstra_radix(s, t); }); sr += eng.settled();
+        ta += time_ms([&]{ da = eng.astar(s, t, manhattan(t)); }); sa += eng.settled();
+        if(dd!=dr || dd!=da) agree = false;
+    }
+    cout << "4-ary heap: avg time(ms)=" << td/Q << ", avg settled=" << sd/Q << "\n";
+    cout << "Radix heap: avg time(ms)=" << tr/Q << ", avg settled=" << sr/Q << "\n";
+    cout << "A* (4-ary): avg time(ms)=" << ta/Q << ", avg settled=" << sa/Q << "\n";
+    cout << (agree ? "All three agree on every query distance.\n" : "WARNING: query distances disagree!\n");
+    cout << "(Legacy Graph::dijkstra has no early exit: every query costs a full run, ~" << t0 << " ms here.)\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    wait_for_enter();
+}
+
+/////////////////////// Section F3: Parallel shortest paths ///////////////////////
+// Splits [0,n) into contiguous chunks and runs fn(tid, begin, end) on up to `threads` threads.
+// Ranges smaller than two grains run inline: spawning threads costs more than relaxing a few edges.
+template<typename F>
+void parallel_chunks(size_t n, int threads, size_t grain, F fn) {
+    if(threads<=1 || n < 2*grain) { fn(0, (size_t)0, n); return; }
+    int t = (int)min<size_t>((size_t)threads, n/grain);
+    size_t chunk = (n + t - 1) / t;
+    vector<thread> pool;
+    for(int i=1;i<t;++i) pool.emplace_back(fn, i, min(n, i*chunk), min(n, (i+1)*chunk));
+    fn(0, (size_t)0, min(n, chunk));
+    for(auto &th: pool) th.join();
+}
+
+// Lowers a to v if v is smaller; returns true when this call made the improvement.
+inline bool atomic_fetch_min(atomic<long long>& a, long long v) {
+    long long cur = a.load(memory_order_relaxed);
+    while(v < cur) if(a.compare_exchange_weak(cur, v, memory_order_relaxed)) return true;
+    return false;
+}
+
+// Delta-stepping SSSP (Meyer & Sanders). Vertices are kept in buckets of width delta;
+// the current bucket's light edges (w <= delta) are relaxed repeatedly in parallel until it
+// stops refilling, then heavy edges of every vertex settled in it are relaxed once.
+class DeltaStepping {
+    const CSRGraph& g;
+    long long delta;
+    int threads;
+    vector<int> tgt, wgt;          // CSR edges reordered so each vertex's light edges come first
+    vector<long long> light_end;   // light edges of u: [offsets[u], light_end[u])
+    unique_ptr<atomic<long long>[]> dist;
+    vector<vector<int>> buckets, out;
+    vector<int> stamp;             // last frontier round a vertex was expanded in (dedupe)
+    vector<char> in_settled;
+
+    void relax(const vector<int>& frontier, bool light) {
+        parallel_chunks(frontier.size(), threads, 1024, [&](int tid, size_t b, size_t e){
+            auto &mine = out[tid];
+            for(size_t i=b;i<e;++i) {
+                int u = frontier[i];
+                long long du = dist[u].load(memory_order_relaxed);
+                long long lo = light ? g.offsets[u] : light_end[u];
+                long long hi = light ? light_end[u] : g.offsets[u+1];
+                for(long long k=lo;k<hi;++k)
+                    if(atomic_fetch_min(dist[tgt[k]], du + wgt[k])) mine.push_back(tgt[k]);
+            }
+        });
+        for(auto &mine: out) {
+            for(int v: mine) {
+                size_t bi = (size_t)(dist[v].load(memory_order_relaxed) / delta);
+                if(bi >= buckets.size()) buckets.resize(bi+1);
+                buckets[bi].push_back(v);
+            }
+            mine.clear();
+        }
+    }
+public:
+    DeltaStepping(const CSRGraph& graph, long long delta_, int threads_)
+        : g(graph), delta(max(1LL, delta_)), threads(max(1, threads_)),
+          tgt(graph.targets.size()), wgt(graph.weights.size()), light_end(graph.n),
+          dist(new atomic<long long>[graph.n]), out(max(1, threads_)), stamp(graph.n, -1), in_settled(graph.n, 0) {
+        for(int u=0;u<g.n;++u) {
+            long long lo = g.offsets[u], hi = g.offsets[u+1], k = lo;
+            for(long long e=lo;e<hi;++e) if(g.weights[e] <= delta) { tgt[k]=g.targets[e]; wgt[k]=g.weights[e]; ++k; }
+            light_end[u] = k;
+            for(long long e=lo;e<hi;++e) if(g.weights[e] > delta) { tgt[k]=g.targets[e]; wgt[k]=g.weights[e]; ++k; }
+        }
+    }
+
+    vector<long long> run(int s) {
+        for(int v=0;v<g.n;++v) { dist[v].store(SP_INF, memory_order_relaxed); stamp[v] = -1; }
+        buckets.assign(1, vector<int>{s});
+        dist[s].store(0, memory_order_relaxed);
+        vector<int> frontier, settled;
+        int round = 0;
+        for(size_t i=0;i<buckets.size();++i) {
+            settled.clear();
+            while(!buckets[i].empty()) {
+                frontier.clear();
+                for(int v: buckets[i]) {
+                    // skip stale copies (moved to a lower bucket) and duplicates within this round
+                    if((size_t)(dist[v].load(memory_order_relaxed)/delta) != i || stamp[v]==round) continue;
+                    stamp[v] = round; frontier.push_back(v);
+                    if(!in_settled[v]) { in_settled[v]=1; settled.push_back(v); }
+                }
+                buckets[i].clear(); ++round;
+                relax(frontier, true);
+            }
+            relax(settled, false);
+            for(int v: settled) in_settled[v] = 0;
+            vector<int>().swap(buckets[i]);
+        }
+        vector<long long> res(g.n);
+        for(int v=0;v<g.n;++v) res[v] = dist[v].load(memory_order_relaxed);
+        return res;
+    }
+};
+
+// Batch mode: runs an independent 4-ary-heap Dijkstra per source on `threads` workers that
+// pull sources from a shared counter. fn(source_index, engine) is called on the worker thread
+// while the engine still holds that source's distances.
+template<typename F>
+void multi_source_dijkstra(const CSRGraph& g, const vector<int>& sources, int threads, F fn) {
+    atomic<size_t> next(0);
+    auto worker = [&]{
+        ShortestPathEngine eng(g);
+        for(size_t i; (i = next.fetch_add(1)) < sources.size(); ) {
+            eng.dijkstra(sources[i]);
+            fn(i, eng);
+        }
+    };
+    vector<thread> pool;
+    for(int t=1;t<threads;++t) pool.emplace_back(worker);
+    worker();
+    for(auto &th: pool) th.join();
+}
+
+void demo_parallel_sssp() {
+    cout << "=== Parallel Shortest Paths (delta-stepping + multi-source) ===\n";
+    cout << "Grid side (e.g., 1000 -> 10^6 nodes): ";
+    int side;
+    if(!(cin>>side) || side<2) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); return; }
+    cout << "Delta (0 = auto, mean edge weight): ";
+    long long delta; cin >> delta;
+    int hw = max(1, (int)thread::hardware_concurrency());
+    cout << "Max threads (hardware reports " << hw << "): ";
+    int maxT; if(!(cin>>maxT) || maxT<1) maxT = hw;
+
+    Graph g = make_grid_graph(side, side);
+    CSRGraph csr(g);
+    if(delta<=0) delta = max(1LL, accumulate(csr.weights.begin(), csr.weights.end(), 0LL) / max(1LL, csr.edges()));
+    cout << "Nodes=" << csr.n << " edges=" << csr.edges() << " delta=" << delta << "\n";
+
+    ShortestPathEngine eng(csr);
+    double ts = time_ms([&]{ eng.dijkstra(0); });
+    cout << "\n-- Single source: serial Dijkstra time(ms)=" << ts << " --\n";
+    cout << "threads  delta-stepping(ms)  speedup-vs-Dijkstra  correct\n";
+    for(int t=1;t<=maxT;++t) {
+        DeltaStepping ds(csr, delta, t);
+        vector<long long> d;
+        double td = time_ms([&]{ d = ds.run(0); });
+        bool ok = true;
+        for(int v=0;v<csr.n && ok;++v) ok = (d[v]==eng.distance(v));
+        cout << setw(7) << t << setw(20) << td << setw(21) << ts/td << "  " << (ok ? "yes" : "NO") << "\n";
+    }
+
+    int K = 8;
+    vector<int> sources;
+    std::mt19937 rng(11);
+    for(int i=0;i<K;++i) sources.push_back((int)(rng()%csr.n));
+    cout << "\n-- Multi-source batch: " << K << " sources, eccentricity per source --\n";
+    cout << "threads  batch(ms)  speedup\n";
+    double t1 = 0;
+    for(int t=1;t<=maxT;++t) {
+        vector<long long> ecc(K, 0);
+        double tb = time_ms([&]{
+            multi_source_dijkstra(csr, sources, t, [&](size_t i, const ShortestPathEngine& e){
+                long long m = 0;
+                for(int v=0;v<csr.n;++v) if(e.distance(v)<SP_INF) m = max(m, e.distance(v));
+                ecc[i] = m;
+            });
+        });
+        if(t==1) t1 = tb;
+        cout << setw(7) << t << setw(11) << tb << setw(9) << t1/tb << "\n";
+    }
+    cout << "(Speedups are bounded by the core count; with one core expect ~1.0x or slightly below.)\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    wait_for_enter();
+}
+
+/////////////////////// Section F4: Edge-list ingestion ///////////////////////
+// Read-only view of a whole file: mmap on POSIX systems, a heap copy elsewhere.
+class MappedFile {
+    string copy;   // backing store only where mmap is unavailable
+public:
+    const char* data = nullptr;
+    size_t size = 0;
+    explicit MappedFile(const string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd<0) throw runtime_error("cannot open " + path);
+        struct stat st;
+        if(fstat(fd, &st)!=0) { close(fd); throw runtime_error("cannot stat " + path); }
+        size = (size_t)st.st_size;
+        if(size>0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p==MAP_FAILED) { close(fd); throw runtime_error("mmap failed for " + path); }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = (const char*)p;
+        }
+        close(fd);
+#else
+        ifstream in(path, ios::binary);
+        if(!in) throw runtime_error("cannot open " + path);
+        copy.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        data = copy.data(); size = copy.size();
+#endif
+    }
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if(data) munmap((void*)data, size);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// Runs fn(tid) on T threads (the caller is thread 0).
+template<typename F>
+void run_on_threads(int T, F fn) {
+    vector<thread> pool;
+    for(int t=1;t<T;++t) pool.emplace_back(fn, t);
+    fn(0);
+    for(auto &th: pool) th.join();
+}
+
+// Parses "u v [w]" lines whose fields are separated by spaces, tabs or commas.
+// Lines starting with '#' or '%' are comments and blank lines are ignored. Every other line
+// must hold two or three non-negative integers (weights at most INT_MAX); anything else, such
+// as "-3", "2.5" or a fourth field, is skipped and counted. Returns the malformed line count.
+template<typename F>
+long long parse_edge_lines(const char* p, const char* end, F fn) {
+    auto is_sep = [](char c){ return c==' ' || c=='\t' || c==',' || c=='\r'; };
+    long long malformed = 0;
+    while(p<end) {
+        if(*p=='#' || *p=='%') { while(p<end && *p!='\n') ++p; if(p<end) ++p; continue; }
+        long long vals[3]; int k = 0; bool ok = true;
+        while(p<end && *p!='\n') {
+            if(*p>='0' && *p<='9') {
+                long long x = 0;
+                while(p<end && *p>='0' && *p<='9') { x = min(x*10 + (*p++ - '0'), (long long)INT_MAX + 1); }
+                if(k<3) vals[k++] = x; else ok = false;
+                if(p<end && *p!='\n' && !is_sep(*p)) ok = false;   // "2.5", "7x"
+            } else {
+                if(!is_sep(*p)) ok = false;                         // '-', '.', stray text
+                ++p;
+            }
+        }
+        if(p<end) ++p;
+        if(k==3 && vals[2] > INT_MAX) ok = false;
+        if(ok && k>=2) fn(vals[0], vals[1], k==3 ? vals[2] : 1LL);
+        else if(k>0 || !ok) ++malformed;
+    }
+    return malformed;
+}
+
+// Cuts [data, data+size) into `parts` ranges that each start at the beginning of a line.
+vector<const char*> split_at_lines(const char* data, size_t size, int parts) {
+    const char* end = data + size;
+    vector<const char*> cuts{data};
+    for(int i=1;i<parts;++i) {
+        const char* p = max(data + size*i/parts, cuts.back());
+        while(p<end && p>data && p[-1]!='\n') ++p;
+        cuts.push_back(p);
+    }
+    cuts.push_back(end);
+    return cuts;
+}
+
+// Sorts every row by target and collapses parallel edges to the lightest one, compacting in place.
+void sort_and_dedupe_rows(CSRGraph& g, int threads) {
+    vector<long long> kept(g.n+1, 0);
+    parallel_chunks((size_t)g.n, threads, 4096, [&](int, size_t b, size_t e){
+        vector<pair<int,int>> row;
+        for(size_t u=b;u<e;++u) {
+            long long lo = g.offsets[u], hi = g.offsets[u+1];
+            row.clear();
+            for(long long k=lo;k<hi;++k) row.push_back({g.targets[k], g.weights[k]});
+            sort(row.begin(), row.end());
+            row.erase(unique(row.begin(), row.end(), [](const pair<int,int>& a, const pair<int,int>& c){ return a.first==c.first; }), row.end());
+            for(size_t i=0;i<row.size();++i) { g.targets[lo+i] = row[i].first; g.weights[lo+i] = row[i].second; }
+            kept[u+1] = (long long)row.size();
+        }
+    });
+    // compact rows in place: every row only moves towards the front
+    long long w = 0;
+    for(int u=0;u<g.n;++u) {
+        long long lo = g.offsets[u];
+        for(long long i=0;i<kept[u+1];++i) { g.targets[w+i] = g.targets[lo+i]; g.weights[w+i] = g.weights[lo+i]; }
+        g.offsets[u] = w; w += kept[u+1];
+    }
+    g.offsets[g.n] = w;
+    g.targets.resize(w); g.targets.shrink_to_fit();
+    g.weights.resize(w); g.weights.shrink_to_fit();
+}
+
+struct EdgeListOptions { int threads = 1; bool symmetrize = false; bool dedupe = true; };
+struct IngestStats { size_t bytes = 0; long long raw_edges = 0, malformed_lines = 0; double parse_ms = 0, build_ms = 0; };
+
+// Streams an edge list straight into CSR with two parallel passes over the mapped file:
+// pass 1 counts degrees, pass 2 scatters edges into their rows. No intermediate edge
+// array is kept, so peak memory is the CSR itself plus one degree array per thread.
+// With dedupe, each row is sorted and parallel edges collapse to the lightest one.
+CSRGraph load_edge_list(const string& path, const EdgeListOptions& opt, IngestStats* stats=nullptr) {
+    MappedFile f(path);
+    int T = max(1, opt.threads);
+    auto cuts = split_at_lines(f.data, f.size, T);
+    Timer tp;
+
+    vector<vector<unsigned>> deg(T);
+    vector<long long> raw(T, 0), maxid(T, -1), malformed(T, 0);
+    run_on_threads(T, [&](int tid){
+        auto &d = deg[tid];
+        malformed[tid] = parse_edge_lines(cuts[tid], cuts[tid+1], [&](long long u, long long v, long long){
+            maxid[tid] = max(maxid[tid], max(u, v));
+            if(maxid[tid] >= INT_MAX) return;   // rejected below; never size d for an out-of-range id
+            size_t need = (size_t)max(u, v) + 1;
+            if(d.size()<need) d.resize(max(need, d.size()*2));
+            ++d[u]; if(opt.symmetrize) ++d[v];
+            ++raw[tid];
+        });
+    });
+    CSRGraph g;
+    long long top = *max_element(maxid.begin(), maxid.end());
+    if(top >= INT_MAX) throw runtime_error("vertex id exceeds 32-bit range");
+    g.n = (int)(top + 1);
+    g.offsets.assign(g.n+1, 0);
+    for(auto &d: deg) {
+        for(size_t u=0; u<d.size() && (int)u<g.n; ++u) g.offsets[u+1] += d[u];
+        vector<unsigned>().swap(d);
+    }
+    for(int u=0;u<g.n;++u) g.offsets[u+1] += g.offsets[u];
+    g.targets.resize(g.offsets[g.n]); g.weights.resize(g.offsets[g.n]);
+
+    // Row cursors are bumped atomically only when several threads scatter at once;
+    // a locked add costs several times a plain increment on a single parser.
+    vector<long long> cursor(g.offsets.begin(), g.offsets.end()-1);
+    auto scatter = [&](auto bump){
+        run_on_threads(T, [&](int tid){
+            parse_edge_lines(cuts[tid], cuts[tid+1], [&](long long u, long long v, long long w){
+                long long k = bump(u);
+                g.targets[k] = (int)v; g.weights[k] = (int)w;
+                if(opt.symmetrize) { k = bump(v); g.targets[k] = (int)u; g.weights[k] = (int)w; }
+            });
+        });
+    };
+    if(T==1) scatter([&](long long u){ return cursor[u]++; });
+    else scatter([&](long long u){ return __atomic_fetch_add(&cursor[u], 1LL, __ATOMIC_RELAXED); });
+    vector<long long>().swap(cursor);
+    double parse_ms = tp.elapsed_ms();
+
+    Timer tb;
+    if(opt.dedupe) sort_and_dedupe_rows(g, T);
+    if(stats) {
+        stats->bytes = f.size; stats->parse_ms = parse_ms; stats->build_ms = tb.elapsed_ms();
+        stats->raw_edges = accumulate(raw.begin(), raw.end(), 0LL);
+        stats->malformed_lines = accumulate(malformed.begin(), malformed.end(), 0LL);
+    }
+    return g;
+}
+
+// Binary CSR file: magic "AICSR01", n and m as int64, then offsets[n+1] (int64),
+// targets[m] and weights[m] (int32). Loading is a bounds check plus three memcpys.
+static const char CSR_MAGIC[8] = {'A','I','C','S','R','0','1','\0'};
+
+void save_csr_binary(const CSRGraph& g, const string& path) {
+    ofstream out(path, ios::binary);
+    if(!out) throw runtime_error("cannot write " + path);
+    long long n = g.n, m = g.edges();
+    out.write(CSR_MAGIC, 8);
+    out.write((const char*)&n, sizeof n); out.write((const char*)&m, sizeof m);
+    out.write((const char*)g.offsets.data(), (n+1)*sizeof(long long));
+    out.write((const char*)g.targets.data(), m*sizeof(int));
+    out.write((const char*)g.weights.data(), m*sizeof(int));
+    if(!out) throw runtime_error("short write to " + path);
+}
+
+CSRGraph load_csr_binary(const string& path) {
+    MappedFile f(path);
+    long long n = 0, m = 0;
+    if(f.size < 24 || memcmp(f.data, CSR_MAGIC, 8)!=0) throw runtime_error(path + " is not a CSR binary file");
+    memcpy(&n, f.data+8, 8); memcpy(&m, f.data+16, 8);
+    // range-check n and m first so the size arithmetic below cannot overflow
+    if(n<0 || n>=INT_MAX || m<0 || (size_t)m > f.size) throw runtime_error(path + " is truncated or corrupt");
+    size_t expect = 24 + (size_t)(n+1)*sizeof(long long) + (size_t)m*2*sizeof(int);
+    if(f.size != expect) throw runtime_error(path + " is truncated or corrupt");
+    CSRGraph g;
+    g.n = (int)n;
+    g.offsets.resize(n+1); g.targets.resize(m); g.weights.resize(m);
+    const char* p = f.data + 24;
+    memcpy(g.offsets.data(), p, (n+1)*sizeof(long long)); p += (n+1)*sizeof(long long);
+    if(m) {   // an edgeless graph has empty (possibly null) arrays
+        memcpy(g.targets.data(), p, m*sizeof(int)); p += m*sizeof(int);
+        memcpy(g.weights.data(), p, m*sizeof(int));
+    }
+    bool valid = g.offsets[0]==0 && g.offsets[n]==m;
+    for(long long u=0; valid && u<n; ++u) valid = g.offsets[u] <= g.offsets[u+1];
+    for(long long k=0; valid && k<m; ++k) valid = g.targets[k]>=0 && g.targets[k]<g.n;
+    if(!valid) throw runtime_error(path + " has out-of-range offsets or targets");
+    return g;
+}
+
+// Writes m random "u v w" lines over m/8 vertices, mixing tab/space/comma separators,
+// with roughly 5% repeated edges so deduplication has something to do.
+void write_synthetic_edge_list(const string& path, long long m) {
+    ofstream out(path, ios::binary);
+    std::mt19937_64 rng(2024);
+    long long n = max(2LL, m/8);
+    const char* seps[3] = {" ", "\t", ","};
+    out << "# synthetic edge list: u v weight\n";
+    string buf; buf.reserve(1<<20);
+    long long pu = 0, pv = 1;
+    for(long long i=0;i<m;++i) {
+        long long u = (long long)(rng()%n), v = (long long)(rng()%n);
+        if(i>0 && rng()%20==0) { u = pu; v = pv; }
+        const char* s = seps[i%3];
+        buf += to_string(u); buf += s; buf += to_string(v); buf += s; buf += to_string(1 + rng()%100); buf += '\n';
+        pu = u; pv = v;
+        if(buf.size() > (1<<20)) { out.write(buf.data(), buf.size()); buf.clear(); }
+    }
+    out.write(buf.data(), buf.size());
+}
+
+void demo_edge_ingestion() {
+    cout << "=== Edge-List Ingestion (mmap + parallel parser -> CSR) ===\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Edge-list path (empty = generate a synthetic file): ";
+    string path; getline(cin, path);
+    if(path.empty()) {
+        cout << "Edges to generate (e.g., 5000000): ";
+        long long m; if(!(cin>>m) || m<1) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); return; }
+        path = "synthetic_edges.txt";
+        double tg = time_ms([&]{ write_synthetic_edge_list(path, m); });
+        cout << "Wrote " << path << " in " << tg << " ms\n";
+    } else cout << "Using " << path << "\n";
+    int hw = max(1, (int)thread::hardware_concurrency());
+    cout << "Parser threads (hardware reports " << hw << "): ";
+    EdgeListOptions opt;
+    if(!(cin>>opt.threads) || opt.threads<1) opt.threads = hw;
+    cout << "Treat edges as undirected (add reverse edges)? 0/1: ";
+    int sym; cin >> sym; opt.symmetrize = (sym==1);
+
+    try {
+        IngestStats st;
+        CSRGraph g = load_edge_list(path, opt, &st);
+        double gb = st.bytes / 1e9;
+        cout << "\nInput: " << st.bytes << " bytes, " << st.raw_edges << " edge lines";
+        if(st.malformed_lines) cout << ", " << st.malformed_lines << " malformed lines skipped";
+        cout << "\n";
+        cout << "CSR:   " << g.n << " vertices, " << g.edges() << " unique edges\n";
+        cout << "Parse (2 passes): " << st.parse_ms << " ms -> " << gb / (st.parse_ms/1000.0) << " GB/s\n";
+        cout << "Row sort + dedupe: " << st.build_ms << " ms; end-to-end " << gb / ((st.parse_ms+st.build_ms)/1000.0) << " GB/s\n";
+
+        string bin = path + ".csr";
+        double ts = time_ms([&]{ save_csr_binary(g, bin); });
+        CSRGraph h;
+        double tl = time_ms([&]{ h = load_csr_binary(bin); });
+        bool same = h.n==g.n && h.offsets==g.offsets && h.targets==g.targets && h.weights==g.weights;
+        cout << "Binary save: " << ts << " ms, binary load: " << tl << " ms (" << (same ? "identical" : "MISMATCH") << ") -> " << bin << "\n";
+    } catch(exception &e) {
+        cout << "Ingestion error: " << e.what() << "\n";
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    wait_for_enter();
+}
+
+/////////////////////// Section F5: Vertex reordering ///////////////////////
+// Each pass returns new_id[old_id]; apply it with relabel(). Good orders put vertices that
+// are traversed together next to each other, so their dist/rank entries share cache lines.
+
+// Relabels vertices and sorts every row by the new target id.
+CSRGraph relabel(const CSRGraph& g, const vector<int>& new_id) {
+    vector<int> old_of(g.n);
+    for(int v=0;v<g.n;++v) old_of[new_id[v]] = v;
+    CSRGraph h;
+    h.n = g.n; h.offsets.assign(g.n+1, 0);
+    for(int u=0;u<g.n;++u) h.offsets[u+1] = h.offsets[u] + g.degree(old_of[u]);
+    h.targets.resize(g.edges()); h.weights.resize(g.edges());
+    vector<pair<int,int>> row;
+    for(int u=0;u<g.n;++u) {
+        int o = old_of[u];
+        row.clear();
+        for(long long e=g.offsets[o]; e<g.offsets[o+1]; ++e) row.push_back({new_id[g.targets[e]], g.weights[e]});
+        sort(row.begin(), row.end());
+        for(size_t i=0;i<row.size();++i) { h.targets[h.offsets[u]+i] = row[i].first; h.weights[h.offsets[u]+i] = row[i].second; }
+    }
+    return h;
+}
+
+// Hubs first: high-degree vertices are touched most often, so packing them together keeps them cache-resident.
+vector<int> degree_sort_order(const CSRGraph& g) {
+    vector<int> by(g.n);
+    iota(by.begin(), by.end(), 0);
+    stable_sort(by.begin(), by.end(), [&](int a, int b){ return g.degree(a) > g.degree(b); });
+    vector<int> new_id(g.n);
+    for(int i=0;i<g.n;++i) new_id[by[i]] = i;
+    return new_id;
+}
+
+// Reverse Cuthill-McKee: BFS from a low-degree vertex of each component, visiting neighbours
+// in increasing degree, then reverse. Minimizes bandwidth, so BFS frontiers stay contiguous.
+vector<int> rcm_order(const CSRGraph& g) {
+    vector<int> by_degree(g.n), order, nbrs;
+    order.reserve(g.n);
+    iota(by_degree.begin(), by_degree.end(), 0);
+    stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b){ return g.degree(a) < g.degree(b); });
+    vector<char> seen(g.n, 0);
+    for(int s: by_degree) {
+        if(seen[s]) continue;
+        seen[s] = 1;
+        size_t head = order.size();
+        order.push_back(s);
+        while(head < order.size()) {
+            int u = order[head++];
+            nbrs.clear();
+            for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) if(!seen[g.targets[e]]) { seen[g.targets[e]] = 1; nbrs.push_back(g.targets[e]); }
+            sort(nbrs.begin(), nbrs.end(), [&](int a, int b){ return g.degree(a) < g.degree(b); });
+            order.insert(order.end(), nbrs.begin(), nbrs.end());
+        }
+    }
+    vector<int> new_id(g.n);
+    for(int i=0;i<g.n;++i) new_id[order[i]] = g.n-1-i;
+    return new_id;
+}
+
+// Gorder-style greedy placement (Wei et al.): the next vertex is the unplaced one with the highest
+// score against the last `window` placed vertices, where score counts direct edges plus shared
+// neighbours. Neighbours with degree above hub_cap are skipped for the sibling term, as their
+// fan-out would dominate the cost without adding locality. Lazy max-heap; stale entries skipped.
+vector<int> gorder_order(const CSRGraph& g, int window=5, int hub_cap=64) {
+    vector<int> score(g.n, 0), new_id(g.n, -1), order;
+    order.reserve(g.n);
+    priority_queue<pair<int,int>> pq;
+    auto bump = [&](int u, int delta){
+        auto touch = [&](int v){ if(new_id[v]<0) { score[v] += delta; pq.push({score[v], v}); } };
+        for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) {
+            int x = g.targets[e];
+            touch(x);
+            if(g.degree(x) <= hub_cap)
+                for(long long f=g.offsets[x]; f<g.offsets[x+1]; ++f) if(g.targets[f]!=u) touch(g.targets[f]);
+        }
+    };
+    vector<int> seeds = vector<int>(g.n);
+    iota(seeds.begin(), seeds.end(), 0);
+    stable_sort(seeds.begin(), seeds.end(), [&](int a, int b){ return g.degree(a) > g.degree(b); });
+    size_t next_seed = 0;
+    for(int placed=0; placed<g.n; ++placed) {
+        int pick = -1;
+        while(!pq.empty()) {
+            auto top = pq.top(); pq.pop();
+            if(new_id[top.second]<0 && top.first==score[top.second] && top.first>0) { pick = top.second; break; }
+        }
+        if(pick<0) { while(new_id[seeds[next_seed]]>=0) ++next_seed; pick = seeds[next_seed]; }
+        new_id[pick] = placed;
+        order.push_back(pick);
+        bump(pick, +1);
+        if(placed >= window) bump(order[placed-window], -1);
+    }
+    return new_id;
+}
+
+// Kernels used to measure the effect of an order.
+long long csr_bfs(const CSRGraph& g, int s, vector<int>& level) {
+    level.assign(g.n, -1);
+    vector<int> q; q.reserve(g.n);
+    level[s] = 0; q.push_back(s);
+    for(size_t h=0; h<q.size(); ++h) {
+        int u = q[h];
+        for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) if(level[g.targets[e]]<0) { level[g.targets[e]] = level[u]+1; q.push_back(g.targets[e]); }
+    }
+    return (long long)q.size();
+}
+
+vector<double> csr_pagerank(const CSRGraph& g, int iters=10, double damping=0.85) {
+    vector<double> rank(g.n, 1.0/g.n), next(g.n);
+    for(int it=0; it<iters; ++it) {
+        fill(next.begin(), next.end(), (1.0-damping)/g.n);
+        for(int u=0;u<g.n;++u) {
+            int d = g.degree(u);
+            if(d==0) continue;
+            double c = damping * rank[u] / d;
+            for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) next[g.targets[e]] += c;
+        }
+        rank.swap(next);
+    }
+    return rank;
+}
+
+// Friend suggestions for `users`: for each user, the friend-of-friend with most mutual friends.
+long long csr_friend_suggestions(const CSRGraph& g, const vector<int>& users) {
+    vector<int> mutual(g.n, 0), touched;
+    long long checksum = 0;
+    for(int u: users) {
+        for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) {
+            int f = g.targets[e];
+            for(long long k=g.offsets[f]; k<g.offsets[f+1]; ++k) {
+                int c = g.targets[k];
+                if(c==u) continue;
+                if(mutual[c]++ == 0) touched.push_back(c);
+            }
+        }
+        int best = 0;
+        for(int c: touched) { best = max(best, mutual[c]); mutual[c] = 0; }
+        touched.clear();
+        checksum += best;
+    }
+    return checksum;
+}
+
+// Average |u - v| over all edges: a cheap, hardware-independent proxy for locality.
+double mean_edge_gap(const CSRGraph& g) {
+    long double s = 0;
+    for(int u=0;u<g.n;++u) for(long long e=g.offsets[u]; e<g.offsets[u+1]; ++e) s += abs(u - g.targets[e]);
+    return g.edges() ? (double)(s / g.edges()) : 0.0;
+}
+
+// Last-level-cache miss counter via perf_event_open (Linux only). Reports -1 when the kernel
+// refuses access (perf_event_paranoid, containers) or on other platforms.
+struct LLCMissCounter {
+    int fd = -1;
+    LLCMissCounter() {
+#if defined(__linux__)
+        perf_event_attr pe;
+        memset(&pe, 0, sizeof pe);
+        pe.type = PERF_TYPE_HARDWARE; pe.size = sizeof pe;
+        pe.config = PERF_COUNT_HW_CACHE_MISSES;
+        pe.disabled = 1; pe.exclude_kernel = 1; pe.exclude_hv = 1;
+        fd = (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+#endif
+    }
+    ~LLCMissCounter() { if(fd>=0) close(fd); }
+    template<typename F>
+    long long measure(F fn) {
+        if(fd<0) { fn(); return -1; }
+#if defined(__linux__)
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        fn();
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if(read(fd, &count, sizeof count) != (ssize_t)sizeof count) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+};
+
+void demo_vertex_reordering() {
+    cout << "=== Vertex Reordering for Cache Locality ===\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Binary CSR file from menu 11 (empty = road grid with shuffled ids): ";
+    string path; getline(cin, path);
+    CSRGraph base;
+    try {
+        if(!path.empty()) base = load_csr_binary(path);
+        else {
+            cout << "Grid side (e.g., 1000 -> 10^6 nodes): ";
+            int side; if(!(cin>>side) || side<2) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); return; }
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            CSRGraph grid(make_grid_graph(side, side));
+            vector<int> signup(grid.n);   // ids handed out in "signup order", unrelated to locality
+            iota(signup.begin(), signup.end(), 0);
+            shuffle(signup.begin(), signup.end(), std::mt19937(99));
+            base = relabel(grid, signup);
+        }
+    } catch(exception &e) { cout << "Load error: " << e.what() << "\n"; wait_for_enter(); return; }
+    cout << "Graph: " << base.n << " vertices, " << base.edges() << " edges\n\n";
+
+    if(base.n==0) { cout << "Nothing to reorder.\n"; wait_for_enter(); return; }
+
+    std::mt19937 rng(5);
+    vector<int> users_old(2000);
+    for(int &u: users_old) u = (int)(rng()%base.n);
+    LLCMissCounter llc;
+    if(llc.fd<0) cout << "(LLC miss counters unavailable here: perf_event_open refused; showing -1)\n";
+
+    struct Variant { string name; function<vector<int>(const CSRGraph&)> order; };
+    vector<Variant> variants = {
+        {"original ids", [](const CSRGraph& g){ vector<int> id(g.n); iota(id.begin(), id.end(), 0); return id; }},
+        {"degree sort", degree_sort_order},
+        {"RCM", rcm_order},
+        {"Gorder-like", [](const CSRGraph& g){ return gorder_order(g); }},
+    };
+    cout << left << setw(14) << "order" << right << setw(11) << "reorder ms" << setw(10) << "edge gap"
+         << setw(9) << "BFS ms" << setw(13) << "BFS LLC" << setw(9) << "PR ms" << setw(13) << "PR LLC"
+         << setw(10) << "FoF ms" << setw(13) << "FoF LLC" << "\n";
+    for(auto &var: variants) {
+        vector<int> id;
+        double tr = time_ms([&]{ id = var.order(base); });
+        CSRGraph g = relabel(base, id);
+        vector<int> users; for(int u: users_old) users.push_back(id[u]);
+        vector<int> level; double tb = 0, tp = 0, tf = 0;
+        long long mb = llc.measure([&]{ tb = time_ms([&]{ csr_bfs(g, id[0], level); }); });
+        long long mp = llc.measure([&]{ tp = time_ms([&]{ csr_pagerank(g, 10); }); });
+        long long mf = llc.measure([&]{ tf = time_ms([&]{ csr_friend_suggestions(g, users); }); });
+        cout << left << setw(14) << var.name << right << fixed << setprecision(1) << setw(11) << tr << setw(10) << mean_edge_gap(g)
+             << setw(9) << tb << setw(13) << mb << setw(9) << tp << setw(13) << mp << setw(10) << tf << setw(13) << mf << "\n";
+        cout.unsetf(ios::fixed); cout << setprecision(6);
+    }
+    wait_for_enter();
+}
+
+/////////////////////// Section F6: Dynamic graph with snapshots ///////////////////////
+// Readers traverse an immutable GraphSnapshot: a base CSR plus a sorted delta of edges whose
+// state differs from the base. The single writer publishes a new snapshot per batch and folds
+// the delta into a fresh CSR once it outgrows a fraction of the base. A snapshot stays valid
+// for as long as a reader holds it, so traversals never see a half-applied batch.
+// Edges keep their weights: an insert carries its own weight (re-inserting an existing edge
+// changes its weight), and folding copies every weight into the new base.
+struct EdgeDelta { int u, v; bool present; int w; };
+
+struct GraphSnapshot {
+    shared_ptr<const CSRGraph> base;            // rows sorted and duplicate-free
+    shared_ptr<const vector<EdgeDelta>> delta;  // sorted by (u, v), one entry per changed edge
+    long long version = 0, edge_count = 0;
+
+    int n() const { return base->n; }
+
+    // Calls fn(v, w) for every current out-edge of u, in ascending order of v.
+    template<typename F>
+    void for_each_edge(int u, F fn) const {
+        const auto& d = *delta;
+        auto it = lower_bound(d.begin(), d.end(), u, [](const EdgeDelta& x, int key){ return x.u < key; });
+        long long e = base->offsets[u], end = base->offsets[u+1];
+        while(true) {
+            bool more_delta = it!=d.end() && it->u==u;
+            if(e<end && (!more_delta || base->targets[e] < it->v)) { fn(base->targets[e], base->weights[e]); ++e; continue; }
+            if(!more_delta) break;
+            if(e<end && base->targets[e]==it->v) ++e;   // the delta overrides the base entry
+            if(it->present) fn(it->v, it->w);
+            ++it;
+        }
+    }
+
+    // Calls fn(v) for every current out-neighbour of u, in ascending order.
+    template<typename F>
+    void for_each_neighbor(int u, F fn) const { for_each_edge(u, [&](int v, int){ fn(v); }); }
+};
+
+class DynamicGraph {
+    shared_ptr<const GraphSnapshot> current;   // read and replaced only through atomic_load/atomic_store
+    mutex writer;
+    double merge_fraction;
+    long long merges_ = 0;
+
+    // Index of edge u->v in the base CSR, or -1.
+    static long long base_find(const CSRGraph& g, int u, int v) {
+        auto b = g.targets.begin() + g.offsets[u], e = g.targets.begin() + g.offsets[u+1];
+        auto it = lower_bound(b, e, v);
+        return it!=e && *it==v ? (long long)(it - g.targets.begin()) : -1;
+    }
+    static shared_ptr<const CSRGraph> fold(const GraphSnapshot& s) {
+        auto g = make_shared<CSRGraph>();
+        g->n = s.n(); g->offsets.assign(g->n+1, 0);
+        g->targets.reserve(s.edge_count); g->weights.reserve(s.edge_count);
+        for(int u=0;u<g->n;++u) {
+            s.for_each_edge(u, [&](int v, int w){ g->targets.push_back(v); g->weights.push_back(w); });
+            g->offsets[u+1] = (long long)g->targets.size();
+        }
+        return g;
+    }
+public:
+    struct Update { int u, v; bool insert; int w = 1; };
+
+    explicit DynamicGraph(CSRGraph base, double merge_fraction_=0.05): merge_fraction(merge_fraction_) {
+        sort_and_dedupe_rows(base, 1);
+        auto s = make_shared<GraphSnapshot>();
+        s->edge_count = base.edges();
+        s->base = make_shared<const CSRGraph>(std::move(base));
+        s->delta = make_shared<const vector<EdgeDelta>>();
+        current = s;
+    }
+
+    shared_ptr<const GraphSnapshot> snapshot() const { return atomic_load(&current); }
+    long long merges() const { return merges_; }
+
+    // Applies a batch atomically: readers see all of it or none of it. Within a batch the
+    // last update to an edge wins. With `undirected`, every update also applies to v->u; the
+    // mirror sits right after its update so both directions resolve to the same last update.
+    void apply_batch(const vector<Update>& given, bool undirected=true) {
+        lock_guard<mutex> lk(writer);
+        auto cur = atomic_load(&current);
+        const CSRGraph& base = *cur->base;
+        vector<Update> batch;
+        batch.reserve(given.size() * (undirected ? 2 : 1));
+        for(const Update& up: given) {
+            if(up.u<0 || up.v<0 || up.u>=base.n || up.v>=base.n) throw out_of_range("edge endpoint outside graph");
+            batch.push_back(up);
+            if(undirected && up.u!=up.v) batch.push_back({up.v, up.u, up.insert, up.w});
+        }
+        stable_sort(batch.begin(), batch.end(), [](const Update& a, const Update& b){ return a.u!=b.u ? a.u<b.u : a.v<b.v; });
+
+        const auto& old = *cur->delta;
+        auto fresh = make_shared<vector<EdgeDelta>>();
+        fresh->reserve(old.size() + batch.size());
+        long long edge_count = cur->edge_count;
+        size_t i = 0, j = 0;
+        auto key_less = [](int au, int av, int bu, int bv){ return au!=bu ? au<bu : av<bv; };
+        while(i<old.size() || j<batch.size()) {
+            if(j>=batch.size() || (i<old.size() && key_less(old[i].u, old[i].v, batch[j].u, batch[j].v))) { fresh->push_back(old[i++]); continue; }
+            size_t k = j;
+            while(k+1<batch.size() && batch[k+1].u==batch[j].u && batch[k+1].v==batch[j].v) ++k;
+            const Update& last = batch[k];
+            long long at = base_find(base, last.u, last.v);
+            bool was = at>=0;
+            if(i<old.size() && old[i].u==last.u && old[i].v==last.v) { was = old[i].present; ++i; }
+            edge_count += (long long)last.insert - (long long)was;
+            bool same_as_base = last.insert ? at>=0 && base.weights[at]==last.w : at<0;
+            if(!same_as_base) fresh->push_back({last.u, last.v, last.insert, last.w});
+            j = k+1;
+        }
+
+        auto next = make_shared<GraphSnapshot>();
+        next->base = cur->base; next->delta = fresh;
+        next->version = cur->version + 1; next->edge_count = edge_count;
+        if((double)fresh->size() > merge_fraction * max(1LL, base.edges())) {
+            next->base = fold(*next);
+            next->delta = make_shared<const vector<EdgeDelta>>();
+            ++merges_;
+        }
+        atomic_store(&current, shared_ptr<const GraphSnapshot>(next));
+    }
+};
+
+// Checks that every edge u->v of the snapshot has a reverse v->u with the same weight.
+bool snapshot_is_symmetric(const GraphSnapshot& s) {
+    bool ok = true;
+    for(int u=0; ok && u<s.n(); ++u) {
+        s.for_each_edge(u, [&](int v, int w){
+            bool back = false;
+            s.for_each_edge(v, [&](int x, int wx){ if(x==u && wx==w) back = true; });
+            ok = ok && back;
+        });
+    }
+    return ok;
+}
+
+// Self-check for the demo: conflicting updates to both directions of one edge in one batch,
+// and weights that must survive folding the delta into a new base.
+bool check_dynamic_graph() {
+    auto weights_of = [](const GraphSnapshot& s){
+        vector<array<int,3>> edges;
+        for(int u=0;u<s.n();++u) s.for_each_edge(u, [&](int v, int w){ edges.push_back({u, v, w}); });
+        return edges;
+    };
+    auto count_ok = [](const GraphSnapshot& s){
+        long long total = 0;
+        for(int u=0;u<s.n();++u) s.for_each_neighbor(u, [&](int){ ++total; });
+        return total == s.edge_count;
+    };
+    auto has = [](const GraphSnapshot& s, int u, int v, int w){
+        bool found = false;
+        s.for_each_edge(u, [&](int x, int wx){ found = found || (x==v && (w<0 || wx==w)); });
+        return found;
+    };
+    bool ok = true;
+    DynamicGraph dg(CSRGraph(make_grid_graph(4, 4)), 1e9);   // never folds
+    dg.apply_batch({{2, 3, true, 7}, {3, 2, false}});          // 2-3 is a grid edge: the delete wins
+    auto s = dg.snapshot();
+    ok = ok && !has(*s, 2, 3, -1) && !has(*s, 3, 2, -1) && snapshot_is_symmetric(*s) && count_ok(*s);
+    dg.apply_batch({{5, 10, true, 5}, {10, 5, true, 9}});      // new edge: the later weight wins both ways
+    s = dg.snapshot();
+    ok = ok && has(*s, 5, 10, 9) && has(*s, 10, 5, 9) && snapshot_is_symmetric(*s) && count_ok(*s);
+
+    DynamicGraph folding(CSRGraph(make_grid_graph(4, 4)), 0.0);   // folds on every batch
+    folding.apply_batch({{0, 5, true, 42}, {1, 2, true, 77}});
+    DynamicGraph reference(CSRGraph(make_grid_graph(4, 4)), 1e9);
+    reference.apply_batch({{0, 5, true, 42}, {1, 2, true, 77}});
+    ok = ok && folding.merges()==1 && folding.snapshot()->delta->empty()
+            && weights_of(*folding.snapshot()) == weights_of(*reference.snapshot());
+    return ok;
+}
+
+void demo_dynamic_graph() {
+    cout << "=== Dynamic Graph: batched updates with snapshot readers ===\n";
+    cout << "Grid side for the base graph (e.g., 300): ";
+    int side; if(!(cin>>side) || side<2) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); return; }
+    cout << "Updates per batch (e.g., 1000): ";
+    int bsz; cin >> bsz; bsz = max(1, bsz);
+    cout << "Number of batches (e.g., 500): ";
+    int batches; cin >> batches; batches = max(1, batches);
+    cout << "Concurrent BFS reader threads (e.g., 2): ";
+    int readers; cin >> readers; readers = max(0, readers);
+
+    DynamicGraph dg(CSRGraph(make_grid_graph(side, side)));
+    int n = side*side;
+    atomic<bool> done(false);
+    atomic<long long> bfs_runs(0), inconsistent(0);
+    vector<thread> pool;
+    for(int r=0;r<readers;++r) pool.emplace_back([&, r]{
+        std::mt19937 rng(100+r);
+        vector<int> level(n), q; q.reserve(n);
+        while(!done.load()) {
+            auto snap = dg.snapshot();
+            // BFS on a frozen version, then check its edge total matches what the writer published
+            fill(level.begin(), level.end(), -1); q.clear();
+            int s = (int)(rng()%n); level[s] = 0; q.push_back(s);
+            long long seen_edges = 0;
+            for(size_t h=0; h<q.size(); ++h) {
+                int u = q[h];
+                snap->for_each_neighbor(u, [&](int v){ ++seen_edges; if(level[v]<0) { level[v] = level[u]+1; q.push_back(v); } });
+            }
+            long long total = 0;
+            for(int u=0;u<n;++u) snap->for_each_neighbor(u, [&](int){ ++total; });
+            if(total != snap->edge_count) ++inconsistent;
+            ++bfs_runs;
+        }
+    });
+
+    std::mt19937 rng(1);
+    vector<DynamicGraph::Update> batch;
+    Timer t;
+    for(int b=0;b<batches;++b) {
+        batch.clear();
+        auto snap = dg.snapshot();
+        for(int i=0;i<bsz;++i) {
+            int u = (int)(rng()%n);
+            if(rng()%2) batch.push_back({u, (int)(rng()%n), true, 10 + (int)(rng()%91)});
+            else {
+                int victim = -1;   // delete an existing edge of u when there is one
+                snap->for_each_neighbor(u, [&](int v){ if(victim<0) victim = v; });
+                if(victim>=0) batch.push_back({u, victim, false});
+            }
+        }
+        dg.apply_batch(batch);
+    }
+    double el = t.elapsed_ms();
+    done = true;
+    for(auto &th: pool) th.join();
+    auto fin = dg.snapshot();
+    cout << "\nApplied " << (long long)batches*bsz << " updates in " << el << " ms -> "
+         << (long long)batches*bsz / (el/1000.0) << " updates/s (" << dg.merges() << " delta merges)\n";
+    cout << "Final version " << fin->version << ": " << fin->edge_count << " directed edges, delta size " << fin->delta->size() << "\n";
+    cout << "Concurrent BFS traversals completed: " << bfs_runs << ", inconsistent snapshots: " << inconsistent << "\n";
+    cout << "Final snapshot symmetric: " << (snapshot_is_symmetric(*fin) ? "yes" : "NO")
+         << "; self-check (conflicting mirrored updates, weights across a fold): " << (check_dynamic_graph() ? "passed" : "FAILED") << "\n";
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    wait_for_enter();
 }
 
 /////////////////////// Section G: Hashing ///////////////////////
@@ -535,7 +1770,7 @@ void demo_hashing() {
         (void)x;
     }
     cout << "Elapsed (ms) for 10 lookups: " << t.elapsed_ms() << "\n";
-    pause();
+    wait_for_enter();
 }
 
 /////////////////////// Menu ///////////////////////
@@ -550,6 +1785,11 @@ int main_menu(){
     cout << "6. Graphs (BFS/DFS/Dijkstra)\n";
     cout << "7. Hashing (unordered_map demo)\n";
     cout << "8. Run a quick automated micro-benchmark (all sections, small n)\n";
+    cout << "9. Shortest-path engine benchmark (CSR, 4-ary/radix heap, A*)\n";
+    cout << "10. Parallel shortest paths (delta-stepping, multi-source batch)\n";
+    cout << "11. Edge-list ingestion (mmap, parallel parse, binary CSR)\n";
+    cout << "12. Vertex reordering (degree sort, RCM, Gorder) vs BFS/PageRank/suggestions\n";
+    cout << "13. Dynamic graph (batched edge updates, snapshot BFS readers)\n";
     cout << "0. Exit\n";
     cout << "Enter choice: ";
     int c; 
@@ -585,7 +1825,8 @@ void run_all_small() {
     }
     // BST
     {
-        BSTNode* root = nullptr; for(int i=0;i<1000;++i) root = bst_insert(root, i);
+        NodePool<BSTNode> pool;
+        BSTNode* root = nullptr; for(int i=0;i<1000;++i) root = bst_insert(root, i, pool);
         double t = time_ms([&]{ bst_search(root, 999); });
         cout << "BST search (balanced-like insert order) time(ms)="<<t<<"\n";
     }
@@ -596,7 +1837,7 @@ void run_all_small() {
         cout << "BFS on 1000-chain time(ms)="<<t<<"\n";
     }
     cout << "Automated tests done.\n";
-    pause();
+    wait_for_enter();
 }
 
 int main(){
@@ -614,6 +1855,11 @@ int main(){
             case 6: demo_graphs(); break;
             case 7: demo_hashing(); break;
             case 8: run_all_small(); break;
+            case 9: demo_shortest_paths(); break;
+            case 10: demo_parallel_sssp(); break;
+            case 11: demo_edge_ingestion(); break;
+            case 12: demo_vertex_reordering(); break;
+            case 13: demo_dynamic_graph(); break;
             default: cout << "Unknown choice\n"; break;
         }
     }
@@ -21,7 +21,7 @@ if errorlevel 1 (
 
 REM Compile the program
 echo Compiling algorithm_insights.cpp...
-g++ -std=c++17 -O2 algorithm_insights.cpp -o algorithm_insights.exe
+g++ -std=c++17 -O2 -pthread algorithm_insights.cpp -o algorithm_insights.exe
 if errorlevel 1 (
     echo Compilation failed! Check for syntax errors.
     pause
@@ -18,7 +18,7 @@ fi
 
 # Compile the program
 echo "Compiling algorithm_insights.cpp..."
-g++ -std=c++17 -O2 algorithm_insights.cpp -o algorithm_insights
+g++ -std=c++17 -O2 -pthread algorithm_insights.cpp -o algorithm_insights
 if [ $? -ne 0 ]; then
     echo "Compilation failed! Check for syntax errors."
     exit 1